@@ -4,7 +4,10 @@
 #include <memory>
 
 #include "randomcat/engine/input/controller_timer.hpp"
+#include "randomcat/engine/input/input_event.hpp"
+#include "randomcat/engine/input/input_recording.hpp"
 #include "randomcat/engine/input/input_state.hpp"
+#include "randomcat/engine/low_level/profiling.hpp"
 
 namespace randomcat::engine {
     class controller {
@@ -16,26 +19,54 @@ namespace randomcat::engine {
 
         [[nodiscard]] auto const& timer() const noexcept { return m_timer; }
 
-        void tick() noexcept {
-            fetch_raw_events();
-            m_timer.tick(fetch_current_raw_time());
+        // Writes every following tick to _path
+        void start_recording(fs::path const& _path) noexcept(!"Throws on error");
+
+        // From now on, ticks come from the recording at _path instead of SDL and the system
+        // clock, and the timer restarts at the recording's start time. quit_received
+        // becomes true at the end of the recording.
+        void start_replay(fs::path const& _path) noexcept(!"Throws on error");
+
+        [[nodiscard]] auto is_replaying() const noexcept { return m_replayer != nullptr; }
+
+        void tick() noexcept(!"Throws on recording error") {
+            RC_PROFILE_SCOPE("controller::tick");
+
+            if (m_replayer) {
+                replay_tick();
+                return;
+            }
+
+            auto const now = fetch_current_raw_time();
+            fetch_raw_events(now);
+            m_timer.tick(now);
+
+            if (m_recorder) m_recorder->write_tick({now, m_quitReceived}, m_inputStateChanges, m_events);
         }
 
         [[nodiscard]] auto const& inputs() const noexcept { return m_currentInputState; }
         [[nodiscard]] auto const& input_changes() const noexcept { return m_inputStateChanges; }
 
+        // The events behind input_changes, in the order they happened
+        [[nodiscard]] auto const& events() const noexcept { return m_events; }
+
         [[nodiscard]] auto quit_received() const noexcept { return m_quitReceived; }
 
     private:
         input::input_state m_currentInputState;
         input::input_state_changes m_inputStateChanges;
+        input::input_event_queue m_events;
 
         bool m_quitReceived = false;
 
         system_timer m_timer = system_timer{fetch_current_raw_time()};
 
-        std::chrono::milliseconds fetch_current_raw_time() const noexcept;
+        std::unique_ptr<input::input_recorder> m_recorder;
+        std::unique_ptr<input::input_replayer> m_replayer;
+
+        system_timer::time fetch_current_raw_time() const noexcept;
 
-        void fetch_raw_events() noexcept;
+        void fetch_raw_events(system_timer::time _now) noexcept;
+        void replay_tick() noexcept(!"Throws on error");
     };
 }    // namespace randomcat::engine
@@ -3,18 +3,22 @@
 #include <chrono>
 #include <cstdint>
 
+#include "randomcat/engine/input/frame_statistics.hpp"
+
 namespace randomcat::engine {
     class system_timer {
     public:
-        using time = std::chrono::milliseconds;
+        // Time since an arbitrary epoch; only differences are meaningful
+        using time = std::chrono::nanoseconds;
 
-        explicit system_timer(time _startTime) noexcept : m_startTime(_startTime) {}
+        explicit system_timer(time _startTime) noexcept(!"Allocates") : m_startTime(_startTime) {}
 
         // Does not make sense to tick a temporary timer
         void tick(time _currentTime) & noexcept {
             m_lastTickTime = std::move(m_currentTickTime);
             m_currentTickTime = std::move(_currentTime);
             tick_fps();
+            m_frameStatistics.record(m_currentTickTime - m_lastTickTime);
         }
 
         [[nodiscard]] auto current_time() const noexcept { return m_currentTickTime; }
@@ -27,6 +31,10 @@ namespace randomcat::engine {
 
         [[nodiscard]] auto fps() const noexcept { return m_ticksLastSecond; }
 
+        // Every tick's delta_time
+        [[nodiscard]] auto const& frame_stats() const noexcept { return m_frameStatistics; }
+        [[nodiscard]] auto& frame_stats() noexcept { return m_frameStatistics; }
+
     private:
         time m_startTime;
         time m_lastTickTime = m_startTime;
@@ -36,6 +44,8 @@ namespace randomcat::engine {
         std::int16_t m_ticksThisSecond = 0;
         std::int16_t m_ticksLastSecond = 0;
 
+        frame_statistics m_frameStatistics;
+
         void tick_fps() noexcept {
             using namespace std::chrono_literals;
 
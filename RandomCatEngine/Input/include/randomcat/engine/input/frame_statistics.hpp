@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "randomcat/engine/low_level/detail/ring_buffer.hpp"
+
+namespace randomcat::engine {
+    struct frame_time_summary {
+        std::int64_t frames;
+
+        std::chrono::nanoseconds min;
+        std::chrono::nanoseconds mean;
+        std::chrono::nanoseconds p50;
+        std::chrono::nanoseconds p95;
+        std::chrono::nanoseconds p99;
+        std::chrono::nanoseconds max;
+    };
+
+    std::ostream& operator<<(std::ostream& _stream, frame_time_summary const& _summary) noexcept(!"Throws on stream error");
+
+    // Records frame times into a log-linear histogram (as HdrHistogram does), so that
+    // percentiles cost no allocation or sorting and stay within about 3% however many
+    // frames are recorded. The most recent frames are also kept exactly, e.g. for graphs.
+    // record is O(number of budgets).
+    class frame_statistics {
+    public:
+        using time = std::chrono::nanoseconds;
+
+        struct budget_count {
+            time budget;
+            std::int64_t framesOver;
+        };
+
+        static auto constexpr recent_capacity = std::size_t(1024);
+
+        // Budgets for 60 and 30 frames per second
+        [[nodiscard]] static std::vector<time> default_budgets() noexcept(!"Allocates");
+
+        explicit frame_statistics(std::vector<time> const& _budgets = default_budgets()) noexcept(!"Allocates");
+
+        void record(time _frameTime) noexcept;
+        void reset() noexcept;
+
+        [[nodiscard]] std::int64_t frames() const noexcept { return m_frames; }
+
+        // min, mean and max are exact; percentiles are taken from the histogram
+        [[nodiscard]] frame_time_summary summary() const noexcept;
+
+        // _fraction is in [0, 1], e.g. 0.99 for p99
+        [[nodiscard]] time percentile(double _fraction) const noexcept;
+
+        [[nodiscard]] auto const& budgets() const noexcept { return m_budgets; }
+
+        // Oldest first
+        [[nodiscard]] auto const& recent() const noexcept { return m_recent; }
+
+    private:
+        // 2^sub_bucket_bits buckets for each power of two, so each bucket is at most 1/32
+        // of its value wide. Times past 2^max_magnitude ns (about 18 minutes) share the last bucket.
+        static auto constexpr sub_bucket_bits = 5;
+        static auto constexpr sub_bucket_count = std::size_t(1) << sub_bucket_bits;
+        static auto constexpr max_magnitude = 40;
+        static auto constexpr bucket_count = std::size_t(max_magnitude - sub_bucket_bits + 1) * sub_bucket_count;
+
+        [[nodiscard]] static std::size_t bucket_index(time _value) noexcept;
+        [[nodiscard]] static time bucket_midpoint(std::size_t _index) noexcept;
+
+        std::array<std::uint32_t, bucket_count> m_histogram{};
+        util_detail::ring_buffer<time, recent_capacity> m_recent;
+        std::vector<budget_count> m_budgets;
+
+        std::int64_t m_frames = 0;
+        time m_total{0};
+        time m_min = time::max();
+        time m_max{0};
+    };
+}    // namespace randomcat::engine
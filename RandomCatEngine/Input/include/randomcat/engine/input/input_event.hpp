@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "randomcat/engine/input/keycodes.hpp"
+#include "randomcat/engine/low_level/detail/ring_buffer.hpp"
+
+namespace randomcat::engine::input {
+    enum class input_event_type { key_down, key_up, mouse_motion };
+
+    struct input_event {
+        // On the same clock as system_timer
+        std::chrono::nanoseconds timestamp;
+        input_event_type type;
+
+        keycode key;    // key_down and key_up only
+
+        // mouse_motion only
+        std::int16_t deltaX;
+        std::int16_t deltaY;
+    };
+
+    // The events of one tick, oldest first. If more arrive than fit, the oldest are dropped.
+    class input_event_queue {
+    public:
+        static auto constexpr capacity = std::size_t(256);
+
+        [[nodiscard]] auto begin() const noexcept { return m_events.begin(); }
+        [[nodiscard]] auto end() const noexcept { return m_events.end(); }
+
+        [[nodiscard]] auto size() const noexcept { return m_events.size(); }
+        [[nodiscard]] auto empty() const noexcept { return m_events.empty(); }
+
+        [[nodiscard]] auto const& operator[](std::size_t _index) const noexcept { return m_events[_index]; }
+
+        // Events lost to overflow since the last clear
+        [[nodiscard]] auto dropped() const noexcept { return m_dropped; }
+
+        void push(input_event const& _event) noexcept {
+            if (!m_events.push_back(_event)) ++m_dropped;
+        }
+
+        void clear() noexcept {
+            m_events.clear();
+            m_dropped = 0;
+        }
+
+    private:
+        util_detail::ring_buffer<input_event, capacity> m_events;
+        std::size_t m_dropped = 0;
+    };
+}    // namespace randomcat::engine::input
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <fstream>
+#include <optional>
+
+#include <randomcat/util/require_filesystem.hpp>
+
+#include "randomcat/engine/input/controller_timer.hpp"
+#include "randomcat/engine/input/input_event.hpp"
+#include "randomcat/engine/input/input_state.hpp"
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+
+// Binary record of what a controller saw each tick: the tick time, the state changes and
+// the events behind them. Replaying one reproduces the same inputs and the same timer,
+// so that benchmark runs are comparable and can run without a window.
+//
+// The format is a header (magic, version, start time) followed by one record per tick.
+// Integers are little-endian and fixed-width.
+
+namespace randomcat::engine::input {
+    namespace input_recording_detail {
+        struct input_recording_error_tag {};
+    }    // namespace input_recording_detail
+
+    using input_recording_error = util_detail::tag_exception<input_recording_detail::input_recording_error_tag>;
+
+    struct recorded_tick {
+        system_timer::time time;
+        bool quit;
+    };
+
+    class input_recorder {
+    public:
+        explicit input_recorder(fs::path const& _path, system_timer::time _startTime) noexcept(!"Throws on error");
+
+        void write_tick(recorded_tick _tick, input_state_changes const& _changes, input_event_queue const& _events) noexcept(!"Throws on error");
+
+    private:
+        std::ofstream m_stream;
+    };
+
+    class input_replayer {
+    public:
+        explicit input_replayer(fs::path const& _path) noexcept(!"Throws on error");
+
+        [[nodiscard]] auto start_time() const noexcept { return m_startTime; }
+
+        // Replaces _changes and _events with the next tick's. Returns nullopt at the end of
+        // the recording.
+        [[nodiscard]] std::optional<recorded_tick> read_tick(input_state_changes& _changes, input_event_queue& _events) noexcept(!"Throws on error");
+
+    private:
+        std::ifstream m_stream;
+        system_timer::time m_startTime;
+    };
+}    // namespace randomcat::engine::input
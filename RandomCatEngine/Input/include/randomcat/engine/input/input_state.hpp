@@ -1,84 +1,141 @@
 #pragma once
 
 #include <algorithm>
-#include <set>
-#include <unordered_map>
-#include <unordered_set>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
 
 #include "randomcat/engine/input/keycodes.hpp"
 
 namespace randomcat::engine::input {
     enum class key_state { up, down };
+}    // namespace randomcat::engine::input
 
-    class keyboard_input_state_changes {
-    private:
-        std::unordered_map<keycode, key_state> m_newStates;
-        using key_iter_t = typename decltype(m_newStates)::iterator;
-        using key_const_iter_t = typename decltype(m_newStates)::const_iterator;
-
-        key_iter_t key_iter(keycode _key) noexcept { return m_newStates.find(_key); }
+namespace randomcat::engine::input_detail {
+    // SDL keycodes are either characters or scancodes with SDLK_SCANCODE_MASK set. ASCII
+    // characters and every scancode get a bit of their own; other characters, which only
+    // non-US layouts produce, are kept in a list instead.
+    inline auto constexpr dense_character_count = SDL_Keycode(128);
+    inline auto constexpr dense_key_count = std::size_t(dense_character_count) + SDL_NUM_SCANCODES;
 
-        key_const_iter_t key_iter(keycode _key) const noexcept { return m_newStates.find(_key); }
+    [[nodiscard]] inline std::optional<std::size_t> dense_key_index(input::keycode _key) noexcept {
+        auto const raw = raw_key(_key);
 
-        bool key_was_changed(key_iter_t _iter) const noexcept { return _iter != end(m_newStates); }
+        if (raw >= 0 && raw < dense_character_count) return std::size_t(raw);
 
-        bool key_was_changed(key_const_iter_t _iter) const noexcept { return _iter != end(m_newStates); }
+        if (raw & SDLK_SCANCODE_MASK) {
+            auto const scancode = raw & ~SDLK_SCANCODE_MASK;
+            if (scancode >= 0 && scancode < SDL_NUM_SCANCODES) return std::size_t(dense_character_count) + std::size_t(scancode);
+        }
 
-        friend class keyboard_input_state;
+        return std::nullopt;
+    }
 
+    // Does not allocate except the first time as many sparse keys are held at once
+    class key_set {
     public:
-        std::unordered_set<keycode> changed_keys() const noexcept {
-            std::unordered_set<keycode> changedKeys;
-            std::transform(begin(m_newStates), end(m_newStates), std::inserter(changedKeys, begin(changedKeys)), [](auto const& node) {
-                return node.first;
-            });
-            return changedKeys;
+        [[nodiscard]] bool contains(input::keycode _key) const noexcept {
+            if (auto const index = dense_key_index(_key)) return m_dense.test(*index);
+            return std::find(begin(m_sparse), end(m_sparse), _key) != end(m_sparse);
         }
 
+        void set(input::keycode _key, bool _present) noexcept(!"Allocates") {
+            if (auto const index = dense_key_index(_key)) {
+                m_dense.set(*index, _present);
+                return;
+            }
+
+            auto const it = std::find(begin(m_sparse), end(m_sparse), _key);
+
+            if (_present && it == end(m_sparse)) m_sparse.push_back(_key);
+
+            if (!_present && it != end(m_sparse)) {
+                *it = m_sparse.back();
+                m_sparse.pop_back();
+            }
+        }
+
+        void clear() noexcept {
+            m_dense.reset();
+            m_sparse.clear();
+        }
+
+    private:
+        std::bitset<dense_key_count> m_dense;
+        std::vector<input::keycode> m_sparse;
+    };
+}    // namespace randomcat::engine::input_detail
+
+namespace randomcat::engine::input {
+    class keyboard_input_state_changes {
+    public:
+        keyboard_input_state_changes() noexcept(!"Allocates") { m_changedKeys.reserve(initial_change_capacity); }
+
+        // In the order they first changed this tick
+        [[nodiscard]] std::vector<keycode> const& changed_keys() const noexcept { return m_changedKeys; }
+
         void set_key_up(keycode _key) noexcept { set_key_state(_key, key_state::up); }
         void set_key_down(keycode _key) noexcept { set_key_state(_key, key_state::down); }
 
-        void set_key_state(keycode _key, key_state _state) noexcept { m_newStates[_key] = _state; }
+        // If a key changes more than once, the last state wins
+        void set_key_state(keycode _key, key_state _state) noexcept {
+            if (!m_changed.contains(_key)) {
+                m_changed.set(_key, true);
+                m_changedKeys.push_back(_key);
+            }
 
-        bool key_went_to(keycode _key, key_state _state) const noexcept {
-            auto it = key_iter(_key);
-            return key_was_changed(it) && (it->second == _state);
+            m_down.set(_key, _state == key_state::down);
         }
 
+        // Keeps capacity, so that reusing one object each tick does not allocate
+        void clear() noexcept {
+            for (auto key : m_changedKeys) {
+                m_changed.set(key, false);
+                m_down.set(key, false);
+            }
+
+            m_changedKeys.clear();
+        }
+
+        bool key_went_to(keycode _key, key_state _state) const noexcept { return key_was_changed(_key) && key_new_state(_key) == _state; }
+
         auto key_went_up(keycode _key) const noexcept { return key_went_to(_key, key_state::up); }
 
         auto key_went_down(keycode _key) const noexcept { return key_went_to(_key, key_state::down); }
 
-        auto key_was_changed(keycode _key) const noexcept { return key_was_changed(key_iter(_key)); }
+        bool key_was_changed(keycode _key) const noexcept { return m_changed.contains(_key); }
 
-        auto key_new_state(keycode _key) const noexcept { return m_newStates.at(_key); }
+        // Only meaningful if key_was_changed(_key)
+        key_state key_new_state(keycode _key) const noexcept { return m_down.contains(_key) ? key_state::down : key_state::up; }
+
+    private:
+        // More keys than this changing in one tick only costs an allocation
+        static auto constexpr initial_change_capacity = std::size_t(32);
+
+        input_detail::key_set m_changed;
+        input_detail::key_set m_down;
+        std::vector<keycode> m_changedKeys;
     };
 
     // Note: key_state is presumed to be "up" until set.
     class keyboard_input_state {
     public:
-        [[nodiscard]] auto key_is_down(keycode _key) const noexcept { return get_key_state(_key) == key_state::down; }
+        [[nodiscard]] auto key_is_down(keycode _key) const noexcept { return m_down.contains(_key); }
 
-        [[nodiscard]] auto key_is_up(keycode _key) const noexcept { return get_key_state(_key) == key_state::up; }
+        [[nodiscard]] auto key_is_up(keycode _key) const noexcept { return !key_is_down(_key); }
 
-        [[nodiscard]] key_state get_key_state(keycode _key) const noexcept {
-            auto const it = m_map.find(_key);
+        [[nodiscard]] key_state get_key_state(keycode _key) const noexcept { return key_is_down(_key) ? key_state::down : key_state::up; }
 
-            if (it != m_map.end()) {
-                return it->second;
-            } else {
-                return key_state::up;
-            }
-        }
+        void set_key_state(keycode _key, key_state _state) noexcept { m_down.set(_key, _state == key_state::down); }
 
-        void update(keyboard_input_state_changes const& _changes) {
-            std::for_each(begin(_changes.m_newStates), end(_changes.m_newStates), [&, this](auto const& changeNode) {
-                m_map[changeNode.first] = changeNode.second;
-            });
+        void update(keyboard_input_state_changes const& _changes) noexcept {
+            for (auto key : _changes.changed_keys()) set_key_state(key, _changes.key_new_state(key));
         }
 
     private:
-        std::unordered_map<keycode, key_state> m_map;
+        input_detail::key_set m_down;
     };
 
     class mouse_input_state_changes {
@@ -89,6 +146,11 @@ namespace randomcat::engine::input {
         auto delta_x() const noexcept { return m_relX; }
         auto delta_y() const noexcept { return m_relY; }
 
+        void clear() noexcept {
+            m_relX = 0;
+            m_relY = 0;
+        }
+
     private:
         std::int16_t m_relX = 0;
         std::int16_t m_relY = 0;
@@ -117,6 +179,11 @@ namespace randomcat::engine::input {
         auto& keyboard() noexcept { return m_keyboardChanges; }
         auto const& keyboard() const noexcept { return m_keyboardChanges; }
 
+        void clear() noexcept {
+            m_mouseChanges.clear();
+            m_keyboardChanges.clear();
+        }
+
     private:
         mouse_input_state_changes m_mouseChanges;
         keyboard_input_state_changes m_keyboardChanges;
@@ -1,23 +1,56 @@
 #include "randomcat/engine/input/controller.hpp"
 
+#include <algorithm>
+
 #include <SDL2/SDL_events.h>
 #include <SDL2/SDL_timer.h>
 
 namespace randomcat::engine {
-    void controller::fetch_raw_events() noexcept {
-        input::input_state_changes changes;
+    namespace {
+        // SDL stamps events in milliseconds since SDL_Init. Shifting those onto the
+        // performance counter clock keeps their order and spacing to the millisecond; they are
+        // clamped to the tick so that they never appear to come from another one.
+        class event_clock {
+        public:
+            explicit event_clock(system_timer::time _previousTick, system_timer::time _now) noexcept
+            : m_previousTick(_previousTick), m_now(_now), m_offset(_now - std::chrono::milliseconds{SDL_GetTicks()}) {}
+
+            [[nodiscard]] system_timer::time to_time(Uint32 _sdlTimestamp) const noexcept {
+                return std::clamp(m_offset + std::chrono::milliseconds{_sdlTimestamp}, m_previousTick, m_now);
+            }
+
+        private:
+            system_timer::time m_previousTick;
+            system_timer::time m_now;
+            system_timer::time m_offset;
+        };
+    }    // namespace
+
+    void controller::fetch_raw_events(system_timer::time _now) noexcept {
+        // Reused every tick so that steady-state ticks do not allocate
+        auto& changes = m_inputStateChanges;
+        changes.clear();
+        m_events.clear();
+
+        auto const clock = event_clock(m_timer.current_time(), _now);
 
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
             switch (event.type) {
                 case SDL_KEYDOWN: {
-                    changes.keyboard().set_key_down(input_detail::wrap_key(event.key.keysym.sym));
+                    auto const key = input_detail::wrap_key(event.key.keysym.sym);
+
+                    changes.keyboard().set_key_down(key);
+                    m_events.push({clock.to_time(event.key.timestamp), input::input_event_type::key_down, key, 0, 0});
 
                     break;
                 }
 
                 case SDL_KEYUP: {
-                    changes.keyboard().set_key_up(input_detail::wrap_key(event.key.keysym.sym));
+                    auto const key = input_detail::wrap_key(event.key.keysym.sym);
+
+                    changes.keyboard().set_key_up(key);
+                    m_events.push({clock.to_time(event.key.timestamp), input::input_event_type::key_up, key, 0, 0});
 
                     break;
                 }
@@ -26,6 +59,12 @@ namespace randomcat::engine {
                     changes.mouse().delta_x() += event.motion.xrel;
                     changes.mouse().delta_y() += event.motion.yrel;
 
+                    m_events.push({clock.to_time(event.motion.timestamp),
+                                   input::input_event_type::mouse_motion,
+                                   input::keycode{},
+                                   std::int16_t(event.motion.xrel),
+                                   std::int16_t(event.motion.yrel)});
+
                     break;
                 }
 
@@ -38,8 +77,49 @@ namespace randomcat::engine {
         }
 
         m_currentInputState.update(changes);
-        m_inputStateChanges = std::move(changes);
     }
 
-    std::chrono::milliseconds controller::fetch_current_raw_time() const noexcept { return std::chrono::milliseconds{SDL_GetTicks()}; }
+    void controller::start_recording(fs::path const& _path) noexcept(false) {
+        m_recorder = std::make_unique<input::input_recorder>(_path, m_timer.current_time());
+    }
+
+    void controller::start_replay(fs::path const& _path) noexcept(false) {
+        m_replayer = std::make_unique<input::input_replayer>(_path);
+
+        m_currentInputState = input::input_state();
+        m_timer = system_timer{m_replayer->start_time()};
+    }
+
+    void controller::replay_tick() noexcept(false) {
+        // Real input is discarded, but the queue is still drained so that SDL keeps handling
+        // window events and the window can still be closed
+        auto quitRequested = false;
+
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT) quitRequested = true;
+        }
+
+        auto const tick = m_replayer->read_tick(m_inputStateChanges, m_events);
+
+        if (!tick) {
+            m_inputStateChanges.clear();
+            m_events.clear();
+            m_quitReceived = true;
+            return;
+        }
+
+        m_currentInputState.update(m_inputStateChanges);
+        m_timer.tick(tick->time);
+        m_quitReceived = tick->quit || quitRequested;
+    }
+
+    system_timer::time controller::fetch_current_raw_time() const noexcept {
+        auto const counter = SDL_GetPerformanceCounter();
+        auto const frequency = SDL_GetPerformanceFrequency();
+
+        // Split so that counter * 10^9 cannot overflow
+        auto constexpr nanosecondsPerSecond = Uint64(1'000'000'000);
+        return system_timer::time{(counter / frequency) * nanosecondsPerSecond + (counter % frequency) * nanosecondsPerSecond / frequency};
+    }
 }    // namespace randomcat::engine
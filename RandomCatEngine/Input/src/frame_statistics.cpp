@@ -0,0 +1,103 @@
+#include "randomcat/engine/input/frame_statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace randomcat::engine {
+    using namespace std::chrono_literals;
+
+    namespace {
+        [[nodiscard]] double as_milliseconds(std::chrono::nanoseconds _time) noexcept {
+            return std::chrono::duration<double, std::milli>(_time).count();
+        }
+    }    // namespace
+
+    std::ostream& operator<<(std::ostream& _stream, frame_time_summary const& _summary) noexcept(false) {
+        return _stream << _summary.frames << " frames, ms: min " << as_milliseconds(_summary.min) << ", mean " << as_milliseconds(_summary.mean)
+                       << ", p50 " << as_milliseconds(_summary.p50) << ", p95 " << as_milliseconds(_summary.p95) << ", p99 "
+                       << as_milliseconds(_summary.p99) << ", max " << as_milliseconds(_summary.max);
+    }
+
+    std::vector<frame_statistics::time> frame_statistics::default_budgets() noexcept(false) {
+        return {time(1'000'000'000 / 60), time(1'000'000'000 / 30)};
+    }
+
+    frame_statistics::frame_statistics(std::vector<time> const& _budgets) noexcept(false) {
+        m_budgets.reserve(_budgets.size());
+        for (auto budget : _budgets) m_budgets.push_back(budget_count{budget, 0});
+    }
+
+    void frame_statistics::record(time _frameTime) noexcept {
+        ++m_histogram[bucket_index(_frameTime)];
+        m_recent.push_back(_frameTime);
+
+        for (auto& budget : m_budgets) {
+            if (_frameTime > budget.budget) ++budget.framesOver;
+        }
+
+        ++m_frames;
+        m_total += _frameTime;
+        m_min = std::min(m_min, _frameTime);
+        m_max = std::max(m_max, _frameTime);
+    }
+
+    void frame_statistics::reset() noexcept {
+        m_histogram.fill(0);
+        m_recent.clear();
+
+        for (auto& budget : m_budgets) budget.framesOver = 0;
+
+        m_frames = 0;
+        m_total = 0ns;
+        m_min = time::max();
+        m_max = 0ns;
+    }
+
+    frame_time_summary frame_statistics::summary() const noexcept {
+        if (m_frames == 0) return frame_time_summary{0, 0ns, 0ns, 0ns, 0ns, 0ns, 0ns};
+
+        return frame_time_summary{m_frames, m_min, m_total / m_frames, percentile(0.5), percentile(0.95), percentile(0.99), m_max};
+    }
+
+    frame_statistics::time frame_statistics::percentile(double _fraction) const noexcept {
+        if (m_frames == 0) return 0ns;
+
+        auto const target = std::max(std::int64_t(1), std::int64_t(std::ceil(std::clamp(_fraction, 0.0, 1.0) * double(m_frames))));
+        if (target == m_frames) return m_max;
+
+        auto seen = std::int64_t(0);
+
+        for (std::size_t index = 0; index < bucket_count; ++index) {
+            seen += m_histogram[index];
+
+            // The exact extremes are tighter than the bucket's midpoint
+            if (seen >= target) return std::clamp(bucket_midpoint(index), m_min, m_max);
+        }
+
+        return m_max;
+    }
+
+    std::size_t frame_statistics::bucket_index(time _value) noexcept {
+        auto const value = std::uint64_t(std::clamp(_value.count(), time::rep(0), (time::rep(1) << max_magnitude) - 1));
+
+        // Buckets below 2 * sub_bucket_count are one nanosecond wide
+        if (value < sub_bucket_count) return std::size_t(value);
+
+        auto const magnitude = 63 - __builtin_clzll(value);
+        auto const group = std::size_t(magnitude - sub_bucket_bits + 1);
+
+        return group * sub_bucket_count + std::size_t(value >> (magnitude - sub_bucket_bits)) - sub_bucket_count;
+    }
+
+    frame_statistics::time frame_statistics::bucket_midpoint(std::size_t _index) noexcept {
+        auto const group = _index / sub_bucket_count;
+        auto const subBucket = _index % sub_bucket_count;
+
+        if (group == 0) return time(time::rep(subBucket));
+
+        auto const lower = time::rep(sub_bucket_count + subBucket) << (group - 1);
+        auto const width = time::rep(1) << (group - 1);
+
+        return time(lower + width / 2);
+    }
+}    // namespace randomcat::engine
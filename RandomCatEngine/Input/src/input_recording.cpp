@@ -0,0 +1,131 @@
+#include "randomcat/engine/input/input_recording.hpp"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace randomcat::engine::input {
+    namespace {
+        auto constexpr magic = std::array<char, 4>{'R', 'C', 'I', 'R'};
+        auto constexpr format_version = std::uint32_t(1);
+
+        template<typename Integer>
+        void write_integer(std::ostream& _stream, Integer _value) noexcept(false) {
+            using unsigned_type = std::make_unsigned_t<Integer>;
+            auto const value = unsigned_type(_value);
+
+            std::array<char, sizeof(Integer)> bytes;
+            for (std::size_t i = 0; i < bytes.size(); ++i) bytes[i] = char((value >> (8 * i)) & 0xFF);
+
+            _stream.write(bytes.data(), bytes.size());
+        }
+
+        template<typename Integer>
+        [[nodiscard]] Integer read_integer(std::istream& _stream) noexcept(false) {
+            using unsigned_type = std::make_unsigned_t<Integer>;
+
+            std::array<char, sizeof(Integer)> bytes;
+            if (!_stream.read(bytes.data(), bytes.size())) throw input_recording_error{"Input recording is truncated"};
+
+            auto value = unsigned_type(0);
+            for (std::size_t i = 0; i < bytes.size(); ++i) value |= unsigned_type(unsigned_type(std::uint8_t(bytes[i])) << (8 * i));
+
+            return Integer(value);
+        }
+
+        [[nodiscard]] key_state read_key_state(std::istream& _stream) noexcept(false) {
+            auto const value = read_integer<std::uint8_t>(_stream);
+            if (value > std::uint8_t(key_state::down)) throw input_recording_error{"Input recording has an invalid key state"};
+
+            return key_state(value);
+        }
+
+        [[nodiscard]] input_event_type read_event_type(std::istream& _stream) noexcept(false) {
+            auto const value = read_integer<std::uint8_t>(_stream);
+            if (value > std::uint8_t(input_event_type::mouse_motion)) throw input_recording_error{"Input recording has an invalid event type"};
+
+            return input_event_type(value);
+        }
+    }    // namespace
+
+    input_recorder::input_recorder(fs::path const& _path, system_timer::time _startTime) noexcept(false)
+    : m_stream(_path, std::ios::binary | std::ios::trunc) {
+        if (!m_stream) throw input_recording_error{"Unable to open input recording for writing: " + _path.string()};
+
+        m_stream.write(magic.data(), magic.size());
+        write_integer(m_stream, format_version);
+        write_integer(m_stream, std::int64_t(_startTime.count()));
+    }
+
+    void input_recorder::write_tick(recorded_tick _tick, input_state_changes const& _changes, input_event_queue const& _events) noexcept(false) {
+        write_integer(m_stream, std::int64_t(_tick.time.count()));
+        write_integer(m_stream, std::uint8_t(_tick.quit));
+
+        write_integer(m_stream, _changes.mouse().delta_x());
+        write_integer(m_stream, _changes.mouse().delta_y());
+
+        auto const& keys = _changes.keyboard().changed_keys();
+        write_integer(m_stream, std::uint16_t(keys.size()));
+
+        for (auto key : keys) {
+            write_integer(m_stream, std::int32_t(input_detail::raw_key(key)));
+            write_integer(m_stream, std::uint8_t(_changes.keyboard().key_new_state(key)));
+        }
+
+        write_integer(m_stream, std::uint16_t(_events.size()));
+
+        for (auto const& event : _events) {
+            write_integer(m_stream, std::int64_t(event.timestamp.count()));
+            write_integer(m_stream, std::uint8_t(event.type));
+            write_integer(m_stream, std::int32_t(input_detail::raw_key(event.key)));
+            write_integer(m_stream, event.deltaX);
+            write_integer(m_stream, event.deltaY);
+        }
+
+        if (!m_stream) throw input_recording_error{"Unable to write input recording"};
+    }
+
+    input_replayer::input_replayer(fs::path const& _path) noexcept(false) : m_stream(_path, std::ios::binary), m_startTime(0) {
+        if (!m_stream) throw input_recording_error{"Unable to open input recording: " + _path.string()};
+
+        std::array<char, magic.size()> fileMagic;
+        if (!m_stream.read(fileMagic.data(), fileMagic.size()) || fileMagic != magic) {
+            throw input_recording_error{"Not an input recording: " + _path.string()};
+        }
+
+        if (auto const version = read_integer<std::uint32_t>(m_stream); version != format_version) {
+            throw input_recording_error{"Unsupported input recording version " + std::to_string(version) + ": " + _path.string()};
+        }
+
+        m_startTime = system_timer::time(read_integer<std::int64_t>(m_stream));
+    }
+
+    std::optional<recorded_tick> input_replayer::read_tick(input_state_changes& _changes, input_event_queue& _events) noexcept(false) {
+        if (m_stream.peek() == std::ifstream::traits_type::eof()) return std::nullopt;
+
+        auto const tick = recorded_tick{system_timer::time(read_integer<std::int64_t>(m_stream)), read_integer<std::uint8_t>(m_stream) != 0};
+
+        _changes.clear();
+        _changes.mouse().delta_x() = read_integer<std::int16_t>(m_stream);
+        _changes.mouse().delta_y() = read_integer<std::int16_t>(m_stream);
+
+        for (auto keyCount = read_integer<std::uint16_t>(m_stream); keyCount > 0; --keyCount) {
+            auto const key = input_detail::wrap_key(read_integer<std::int32_t>(m_stream));
+            _changes.keyboard().set_key_state(key, read_key_state(m_stream));
+        }
+
+        _events.clear();
+
+        for (auto eventCount = read_integer<std::uint16_t>(m_stream); eventCount > 0; --eventCount) {
+            auto const timestamp = system_timer::time(read_integer<std::int64_t>(m_stream));
+            auto const type = read_event_type(m_stream);
+            auto const key = input_detail::wrap_key(read_integer<std::int32_t>(m_stream));
+            auto const deltaX = read_integer<std::int16_t>(m_stream);
+            auto const deltaY = read_integer<std::int16_t>(m_stream);
+
+            _events.push({timestamp, type, key, deltaX, deltaY});
+        }
+
+        return tick;
+    }
+}    // namespace randomcat::engine::input
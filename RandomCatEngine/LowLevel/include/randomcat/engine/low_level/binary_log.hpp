@@ -0,0 +1,123 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <initializer_list>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+#include <randomcat/util/require_filesystem.hpp>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+
+// Structured records for diagnostics too frequent for the text log, such as per-frame
+// statistics. A record is an event name and key/value fields, written to a compact
+// binary file that binary_log_reader (or the LogDecoder example) decodes offline.
+//
+// The format is a header (magic, version, wall-clock start time) followed by entries,
+// each a tag byte and a payload. Event names and keys are written once, in a string
+// entry, and referred to by index afterwards. Integers are LEB128 varints (signed ones
+// zigzag-encoded); the start time and doubles are little-endian and fixed-width.
+
+namespace randomcat::engine::log {
+    namespace binary_log_detail {
+        struct binary_log_error_tag {};
+    }    // namespace binary_log_detail
+
+    using binary_log_error = util_detail::tag_exception<binary_log_detail::binary_log_error_tag>;
+
+    using log_field_value = std::variant<bool, std::int64_t, double, std::string_view>;
+
+    // The key and any string value must outlive the write they are passed to
+    struct log_field {
+        std::string_view key;
+        log_field_value value;
+    };
+
+    // Integers are stored as int64 (so unsigned values above INT64_MAX wrap), floating
+    // point values as double, and anything else convertible to a string_view as a string.
+    template<typename T>
+    [[nodiscard]] log_field field(std::string_view _key, T const& _value) noexcept {
+        if constexpr (std::is_same_v<T, bool>) {
+            return log_field{_key, log_field_value(std::in_place_type<bool>, _value)};
+        } else if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            return log_field{_key, log_field_value(std::in_place_type<std::int64_t>, std::int64_t(_value))};
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return log_field{_key, log_field_value(std::in_place_type<double>, double(_value))};
+        } else {
+            return log_field{_key, log_field_value(std::in_place_type<std::string_view>, std::string_view(_value))};
+        }
+    }
+
+    // Not thread-safe; use one writer per thread
+    class binary_log_writer {
+    public:
+        explicit binary_log_writer(fs::path const& _path) noexcept(!"Throws on error");
+
+        // Record times are measured from the writer's creation
+        void write(std::string_view _event, std::initializer_list<log_field> _fields) noexcept(!"Throws on error");
+
+        template<typename... Fields>
+        void write(std::string_view _event, Fields const&... _fields) noexcept(!"Throws on error") {
+            static_assert((std::is_same_v<Fields, log_field> && ...), "Fields must be made with log::field");
+            write(_event, {_fields...});
+        }
+
+        void flush() noexcept(!"Throws on error");
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        [[nodiscard]] std::uint64_t string_index(std::string_view _string) noexcept(!"Allocates");
+
+        std::ofstream m_stream;
+        clock::time_point m_start;
+        clock::duration m_lastTime{0};
+
+        std::vector<std::string> m_strings;
+
+        // Each entry is encoded here and written with one call
+        std::vector<char> m_buffer;
+    };
+
+    using decoded_field_value = std::variant<bool, std::int64_t, double, std::string>;
+
+    struct decoded_field {
+        std::string key;
+        decoded_field_value value;
+    };
+
+    struct decoded_record {
+        // Since the writer was created
+        std::chrono::nanoseconds time;
+
+        std::string event;
+        std::vector<decoded_field> fields;
+    };
+
+    // Writes "<time in ms> <event> key=value ...", with string values quoted
+    std::ostream& operator<<(std::ostream& _stream, decoded_record const& _record) noexcept(!"Throws on stream error");
+
+    class binary_log_reader {
+    public:
+        explicit binary_log_reader(fs::path const& _path) noexcept(!"Throws on error");
+
+        [[nodiscard]] auto start_time() const noexcept { return m_startTime; }
+
+        // Returns nullopt at the end of the log
+        [[nodiscard]] std::optional<decoded_record> read_record() noexcept(!"Throws on error");
+
+    private:
+        std::ifstream m_stream;
+        std::chrono::system_clock::time_point m_startTime;
+        std::chrono::nanoseconds m_lastTime{0};
+
+        std::vector<std::string> m_strings;
+    };
+}    // namespace randomcat::engine::log
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace randomcat::engine::util_detail {
+    // Instruction set extensions that the engine has optimized code paths for. Detected
+    // once, on first use.
+    struct cpu_features {
+        bool sse2;
+        bool ssse3;
+        bool avx2;
+    };
+
+    [[nodiscard]] cpu_features const& detected_cpu_features() noexcept;
+}    // namespace randomcat::engine::util_detail
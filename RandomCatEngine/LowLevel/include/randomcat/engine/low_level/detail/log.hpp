@@ -1,17 +1,86 @@
 #pragma once
 
-#include <chrono>
-#include <functional>
-#include <iomanip>
+#include <atomic>
+#include <cstdint>
 #include <iostream>
 #include <string>
+#include <string_view>
+
+// Levels below RC_ENGINE_LOG_LEVEL (0 info, 1 warn, 2 error, 3 none) are compiled out:
+// RC_LOG and RC_LOG_CATEGORY do not even evaluate their arguments, and log::info and the
+// like do not format them.
+#ifndef RC_ENGINE_LOG_LEVEL
+#    define RC_ENGINE_LOG_LEVEL 0
+#endif
 
 namespace randomcat::engine::log {
     enum class log_type : uint8_t { INFO, WARN, ERROR };
 
     namespace log_detail {
-        inline std::reference_wrapper<std::ostream> g_logStream = std::reference_wrapper<std::ostream>(std::clog);
+        // One past the highest log_type, for filters that let nothing through
+        static auto constexpr silent_level = std::uint8_t(3);
+
+        // For categories that follow the global level
+        static auto constexpr inherit_level = std::uint8_t(0xFF);
+
+        struct category_state {
+            std::string name;
+            std::atomic<std::uint8_t> minLevel{inherit_level};
+        };
+
+        // States are never destroyed, so pointers to them stay valid
+        [[nodiscard]] category_state& find_category(std::string_view _name) noexcept(!"Allocates");
+
+        inline std::atomic<std::uint8_t> g_minLevel{0};
+
+        static auto constexpr compiled_min_level = int(RC_ENGINE_LOG_LEVEL);
+
+        [[nodiscard]] constexpr bool is_compiled_in(log_type _type) noexcept { return int(_type) >= compiled_min_level; }
+
+        [[nodiscard]] inline bool is_enabled(log_type _type, category_state const* _category) noexcept {
+            if (!is_compiled_in(_type)) return false;
+
+            auto minLevel = _category ? _category->minLevel.load(std::memory_order_relaxed) : inherit_level;
+            if (minLevel == inherit_level) minLevel = g_minLevel.load(std::memory_order_relaxed);
+
+            return std::uint8_t(_type) >= minLevel;
+        }
+    }    // namespace log_detail
+
+    // Messages below _level are dropped before they are formatted, except in categories
+    // with a level of their own
+    inline void set_min_level(log_type _level) noexcept { log_detail::g_minLevel.store(std::uint8_t(_level), std::memory_order_relaxed); }
+
+    [[nodiscard]] inline bool is_enabled(log_type _type) noexcept { return log_detail::is_enabled(_type, nullptr); }
+
+    // A named source of messages, which can be filtered separately. Categories with the
+    // same name share their filter. Messages are headed with the category's name.
+    class log_category {
+    public:
+        explicit log_category(std::string_view _name) noexcept(!"Allocates") : m_state(&log_detail::find_category(_name)) {}
+
+        [[nodiscard]] std::string_view name() const noexcept { return m_state->name; }
+
+        [[nodiscard]] bool is_enabled(log_type _type) const noexcept { return log_detail::is_enabled(_type, m_state); }
 
+        [[nodiscard]] log_detail::category_state const* state() const noexcept { return m_state; }
+
+    private:
+        log_detail::category_state* m_state;
+    };
+
+    // These apply to the category _name whether or not it exists yet
+    void set_category_min_level(std::string_view _name, log_type _level) noexcept(!"Allocates");
+    void silence_category(std::string_view _name) noexcept(!"Allocates");
+
+    // Returns the category to following the global level
+    void reset_category_level(std::string_view _name) noexcept(!"Allocates");
+
+    // Logging never blocks the calling thread on I/O. Each insertion is formatted into a
+    // buffer owned by the calling thread and queued; a background thread adds the header
+    // and writes it out. If the queue is full, the insertion is dropped and counted, and
+    // the count is logged once there is room again.
+    namespace log_detail {
         [[nodiscard]] inline std::string_view log_type_header(log_type _logType) noexcept {
             using std::string_view_literals::operator""sv;
 
@@ -24,55 +93,47 @@ namespace randomcat::engine::log {
             return "[INVALID]"sv;
         }
 
+        // Clears the calling thread's format buffer and returns a stream writing to it, with
+        // default formatting. Insertions beyond the buffer's capacity are truncated.
+        [[nodiscard]] std::ostream& begin_record() noexcept;
+
+        // Queues the contents of the calling thread's format buffer
+        void submit_record(log_type _logType, category_state const* _category, bool _isFirst) noexcept;
+
+        // Queues _text, for when formatting failed
+        void submit_record(log_type _logType, category_state const* _category, bool _isFirst, std::string_view _text) noexcept;
+
         // Client code shall not use this type except as the result of library-provided
         // functions, even if it is the result of a decltype or auto variable. Client
         // code shall not store any instance of this type.
         class log_impl {
         public:
-            enum class cont_type { first, continued };
+            // filtered: the message was dropped at its first insertion
+            enum class cont_type { first, continued, filtered };
 
-            explicit log_impl(log_type _logType, cont_type _contType = cont_type::first) noexcept
-            : m_logType(std::move(_logType)), m_contType(std::move(_contType)) {}
+            explicit log_impl(log_type _logType, cont_type _contType = cont_type::first, category_state const* _category = nullptr) noexcept
+            : m_logType(std::move(_logType)), m_contType(std::move(_contType)), m_category(_category) {}
 
             log_impl(log_impl const&) = delete;
             log_impl(log_impl&&) = delete;
 
             template<typename T>
             log_impl operator<<(T const& _val) noexcept {
-                auto& outStream = g_logStream.get();
-
-                try {
-                    std::ostringstream tempOut;
-
-                    bool const isFirst = (m_contType == cont_type::first);
-
-                    if (isFirst)
-                        tempOut << log_header();
-                    else {
-                    }; /* continued, don't output header */
+                bool const isFirst = (m_contType == cont_type::first);
 
-                    tempOut << _val;
-
-                    std::string outString = std::move(tempOut).str();
-
-                    replace_newlines(outString, log_header_cont());
+                if (m_contType == cont_type::filtered || (isFirst && !is_enabled(m_logType, m_category))) {
+                    return log_impl(m_logType, cont_type::filtered, m_category);
+                }
 
-                    outStream << (isFirst ? "\n" : "") << outString;
+                try {
+                    begin_record() << _val;
+                    submit_record(m_logType, m_category, isFirst);
                 } catch (...) {
                     // Drop error, logging is not vital
-                    outStream << "<LOG ERROR>";
+                    submit_record(m_logType, m_category, isFirst, "<LOG ERROR>");
                 }
 
-                return log_impl(m_logType, cont_type::continued);
-            }
-
-            void replace_newlines(std::string& _str, std::string_view _replacement) const noexcept(!"string::replace not noexcept") {
-                auto newLinePos = _str.find('\n');
-
-                while (newLinePos != std::string::npos) {
-                    _str.replace(newLinePos, 1, _replacement);
-                    newLinePos = _str.find('\n', newLinePos + _replacement.length());
-                }
+                return log_impl(m_logType, cont_type::continued, m_category);
             }
 
             template<typename T>
@@ -81,23 +142,9 @@ namespace randomcat::engine::log {
             }
 
         private:
-            [[nodiscard]] std::string log_header() noexcept(!"Ostreaming not noexcept") {
-                std::ostringstream fullMessage{};
-                time_t systemTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-                auto formatTime = *std::localtime(&systemTime);
-
-                fullMessage << "[" << std::put_time(&formatTime, "%Y-%m-%d %H:%M:%S") << "] " << log_type_header(m_logType) << " ";
-
-                return fullMessage.str();
-            }
-
-            [[nodiscard]] static std::string_view log_header_cont() noexcept {
-                using std::string_view_literals::operator""sv;
-                return "\n[CONT] "sv;
-            }
-
             log_type m_logType;
             cont_type m_contType;
+            category_state const* m_category;
         };
     }    // namespace log_detail
 
@@ -109,11 +156,33 @@ namespace randomcat::engine::log {
 
     inline void log(log_type _type, std::string_view _message) noexcept { log(std::move(_type)) << std::move(_message); }
 
-    inline void set_log_output(std::ostream& _stream) noexcept { log_detail::g_logStream = std::ref(_stream); }
+    [[nodiscard]] inline auto log(log_type _type, log_category const& _category) noexcept {
+        return log_detail::log_impl(std::move(_type), log_detail::log_impl::cont_type::first, _category.state());
+    }
+
+    // Blocks until everything logged so far has been written to the output
+    void flush() noexcept;
 
-    [[nodiscard]] inline std::ostream& raw_log() noexcept { return log_detail::g_logStream; }
+    // Flushes, then writes everything logged from now on to _stream
+    void set_log_output(std::ostream& _stream) noexcept;
+
+    // Flushes first, but later queued records may still be written concurrently with
+    // writes to the returned stream
+    [[nodiscard]] std::ostream& raw_log() noexcept;
 
     inline auto info = log(log_type::INFO);
     inline auto warn = log(log_type::WARN);
     inline auto error = log(log_type::ERROR);
 }    // namespace randomcat::engine::log
+
+// Like log::log, but the arguments are not evaluated if the level is compiled out or
+// filtered. For example: RC_LOG(INFO) << "Frame time: " << expensiveSummary();
+#define RC_LOG(level)                                                                                                                              \
+    if (!::randomcat::engine::log::is_enabled(::randomcat::engine::log::log_type::level)) {                                                        \
+    } else                                                                                                                                         \
+        ::randomcat::engine::log::log(::randomcat::engine::log::log_type::level)
+
+#define RC_LOG_CATEGORY(category, level)                                                                                                           \
+    if (!(category).is_enabled(::randomcat::engine::log::log_type::level)) {                                                                       \
+    } else                                                                                                                                         \
+        ::randomcat::engine::log::log(::randomcat::engine::log::log_type::level, (category))
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace randomcat::engine::util_detail {
+    // Fixed-capacity FIFO that never allocates. When full, pushing overwrites the oldest
+    // element. T must be default constructible.
+    template<typename T, std::size_t Capacity>
+    class ring_buffer {
+    public:
+        static_assert(Capacity > 0, "Capacity must be positive");
+        static_assert(std::is_default_constructible_v<T>, "T must be default constructible");
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T const*;
+            using reference = T const&;
+
+            const_iterator() noexcept = default;
+
+            [[nodiscard]] reference operator*() const noexcept { return (*m_buffer)[m_index]; }
+            [[nodiscard]] pointer operator->() const noexcept { return &**this; }
+
+            const_iterator& operator++() noexcept {
+                ++m_index;
+                return *this;
+            }
+
+            const_iterator operator++(int) noexcept {
+                auto copy = *this;
+                ++*this;
+                return copy;
+            }
+
+            [[nodiscard]] bool operator==(const_iterator const& _other) const noexcept { return m_index == _other.m_index; }
+            [[nodiscard]] bool operator!=(const_iterator const& _other) const noexcept { return !(*this == _other); }
+
+        private:
+            explicit const_iterator(ring_buffer const* _buffer, std::size_t _index) noexcept : m_buffer(_buffer), m_index(_index) {}
+
+            ring_buffer const* m_buffer = nullptr;
+            std::size_t m_index = 0;
+
+            friend class ring_buffer;
+        };
+
+        [[nodiscard]] static constexpr std::size_t capacity() noexcept { return Capacity; }
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+        [[nodiscard]] bool full() const noexcept { return m_size == Capacity; }
+
+        // Returns false if the oldest element was overwritten to make room
+        bool push_back(T _value) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            auto const hadRoom = !full();
+
+            m_elements[(m_begin + m_size) % Capacity] = std::move(_value);
+
+            if (hadRoom) {
+                ++m_size;
+            } else {
+                m_begin = (m_begin + 1) % Capacity;
+            }
+
+            return hadRoom;
+        }
+
+        // Precondition: !empty()
+        void pop_front() noexcept {
+            m_begin = (m_begin + 1) % Capacity;
+            --m_size;
+        }
+
+        void clear() noexcept {
+            m_begin = 0;
+            m_size = 0;
+        }
+
+        // Index 0 is the oldest element
+        [[nodiscard]] T& operator[](std::size_t _index) noexcept { return m_elements[(m_begin + _index) % Capacity]; }
+        [[nodiscard]] T const& operator[](std::size_t _index) const noexcept { return m_elements[(m_begin + _index) % Capacity]; }
+
+        [[nodiscard]] T& front() noexcept { return (*this)[0]; }
+        [[nodiscard]] T const& front() const noexcept { return (*this)[0]; }
+
+        [[nodiscard]] T& back() noexcept { return (*this)[m_size - 1]; }
+        [[nodiscard]] T const& back() const noexcept { return (*this)[m_size - 1]; }
+
+        [[nodiscard]] const_iterator begin() const noexcept { return const_iterator(this, 0); }
+        [[nodiscard]] const_iterator end() const noexcept { return const_iterator(this, m_size); }
+
+    private:
+        std::array<T, Capacity> m_elements{};
+        std::size_t m_begin = 0;
+        std::size_t m_size = 0;
+    };
+}    // namespace randomcat::engine::util_detail
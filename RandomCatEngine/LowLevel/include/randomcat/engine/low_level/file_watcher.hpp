@@ -0,0 +1,58 @@
+#pragma once
+
+#if RC_ENGINE_HOT_RELOAD
+#    include <chrono>
+#    include <mutex>
+#    include <set>
+#    include <string>
+#    include <unordered_map>
+#    include <vector>
+
+#    include <randomcat/util/require_filesystem.hpp>
+
+#    include "randomcat/engine/low_level/detail/tag_exception.hpp"
+
+namespace randomcat::engine {
+    namespace file_watcher_detail {
+        struct file_watcher_error_tag {};
+    }    // namespace file_watcher_detail
+
+    using file_watcher_error = util_detail::tag_exception<file_watcher_detail::file_watcher_error_tag>;
+
+    // Reports writes to a set of files, using inotify. The directories containing the
+    // files are watched rather than the files themselves, since editors often save by
+    // writing a new file and renaming it over the old one.
+    //
+    // watch may be called while another thread is in wait_for_changes.
+    class file_watcher {
+    public:
+        file_watcher() noexcept(!"Throws on error");
+        ~file_watcher() noexcept;
+
+        file_watcher(file_watcher const&) = delete;
+        file_watcher(file_watcher&&) = delete;
+
+        file_watcher& operator=(file_watcher const&) = delete;
+        file_watcher& operator=(file_watcher&&) = delete;
+
+        // Returns the path that changes to _path will be reported as
+        fs::path watch(fs::path const& _path) noexcept(!"Throws on error");
+
+        // Blocks until a watched file changes, _timeout passes or interrupt is called.
+        // Each changed file is reported once, however many events it had.
+        [[nodiscard]] std::vector<fs::path> wait_for_changes(std::chrono::milliseconds _timeout) noexcept(!"Throws on error");
+
+        // Wakes up wait_for_changes, e.g. so that its thread can be joined
+        void interrupt() noexcept;
+
+    private:
+        int m_inotify;
+        int m_interrupt;    // eventfd
+
+        std::mutex m_mutex;
+        std::unordered_map<int, fs::path> m_directories;
+        std::unordered_map<std::string, std::set<std::string>> m_files;    // Directory to watched file names
+    };
+}    // namespace randomcat::engine
+
+#endif
@@ -5,6 +5,9 @@
 namespace randomcat::engine::graphics {
     namespace shader_detail {
         inline auto compile_shader(GLenum _type, std::string_view _source) noexcept(!"Throws on error") {
+            RC_PROFILE_SCOPE("compile shader");
+            render_stats_detail::count_shader_compile();
+
             auto shaderID = gl_detail::unique_shader_id(_type);
 
             // Third argument: array of char const*, fourth argument: array of sizes of
@@ -37,39 +40,63 @@ namespace randomcat::engine::graphics {
             return compile_shader(GL_FRAGMENT_SHADER, _source);
         }
 
+        // Attaches _shaders to _program and links it, throwing shader_init_error on failure
         template<typename... Shaders>
-        inline auto link_program(Shaders const&... _shaders) noexcept(false) {
+        inline void link_program_into(gl_detail::opengl_raw_id _program, Shaders const&... _shaders) noexcept(false) {
             static_assert((std::is_same_v<Shaders, gl_detail::unique_shader_id> && ...), "Arguments must all be shader_ids");
 
-            gl_detail::unique_program_id programID;
+            RC_PROFILE_SCOPE("link shader program");
 
-            {
-                // Attach all shaders
-                ((glAttachShader(programID.value(), _shaders.value())), ...);
+            // Attach all shaders
+            ((glAttachShader(_program, _shaders.value())), ...);
 
-                glLinkProgram(programID.value());
+            glLinkProgram(_program);
 
-                GLint success = 0;
-                glGetProgramiv(programID.value(), GL_LINK_STATUS, &success);
+            GLint success = 0;
+            glGetProgramiv(_program, GL_LINK_STATUS, &success);
 
-                if (!success) {
-                    // Raw use of int okay - constant expression
-                    constexpr int BUFFER_LEN = 512;
-                    std::array<char, BUFFER_LEN> errorBuffer{};
+            if (!success) {
+                // Raw use of int okay - constant expression
+                constexpr int BUFFER_LEN = 512;
+                std::array<char, BUFFER_LEN> errorBuffer{};
 
-                    glGetProgramInfoLog(programID.value(), BUFFER_LEN, nullptr, errorBuffer.data());
-                    throw shader_init_error{std::string{"Error linking program: "} + errorBuffer.data()};
-                }
+                glGetProgramInfoLog(_program, BUFFER_LEN, nullptr, errorBuffer.data());
+                throw shader_init_error{std::string{"Error linking program: "} + errorBuffer.data()};
             }
+        }
+
+        template<typename... Shaders>
+        inline auto link_program(Shaders const&... _shaders) noexcept(false) {
+            gl_detail::unique_program_id programID;
+            link_program_into(programID.value(), _shaders...);
 
             return programID;
         }
 
-        inline auto program_binary_size(gl_detail::shared_program_id const& _program) noexcept {
+        inline void detach_all_shaders(gl_detail::opengl_raw_id _program) noexcept(!"Allocates") {
+            GLint count = 0;
+            glGetProgramiv(_program, GL_ATTACHED_SHADERS, &count);
+
+            auto shaders = std::vector<GLuint>(gsl::narrow<std::size_t>(count));
+            glGetAttachedShaders(_program, count, nullptr, shaders.data());
+
+            for (auto shader : shaders) glDetachShader(_program, shader);
+        }
+
+        inline auto program_binary_size(gl_detail::opengl_raw_id _program) noexcept {
             GLint size;
-            glGetProgramiv(_program.value(), GL_PROGRAM_BINARY_LENGTH, &size);
+            glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &size);
             return gsl::narrow<GLuint>(size);
         }
+
+        inline void copy_program_binary(gl_detail::opengl_raw_id _from, gl_detail::opengl_raw_id _to) noexcept {
+            auto const programSize = program_binary_size(_from);
+            auto binary = std::vector<char>(programSize);
+            GLenum binaryFormat;
+
+            glGetProgramBinary(_from, programSize, nullptr, &binaryFormat, binary.data());
+            glProgramBinary(_to, binaryFormat, binary.data(), programSize);
+        }
     }    // namespace shader_detail
 
     template<typename Vertex, typename Capabilities>
@@ -79,17 +106,24 @@ namespace randomcat::engine::graphics {
 
     namespace shader_detail {
         inline gl_detail::shared_program_id clone_program(gl_detail::shared_program_id const& _program) noexcept {
-            auto const programSize = program_binary_size(_program);
-            auto binary = std::vector<char>(programSize);
-            GLenum binaryFormat;
-
-            glGetProgramBinary(_program.value(), programSize, nullptr, &binaryFormat, binary.data());
-
             auto newProgram = gl_detail::shared_program_id();
-            glProgramBinary(newProgram.value(), binaryFormat, binary.data(), programSize);
+            copy_program_binary(_program.value(), newProgram.value());
 
             return newProgram;
         }
+
+        inline void relink_program(gl_detail::shared_program_id const& _program, std::string_view _vertex, std::string_view _fragment) noexcept(false) {
+            auto const vertex = compile_vertex_shader(_vertex);
+            auto const fragment = compile_fragment_shader(_fragment);
+
+            // Linked separately first, so that a failure leaves the old program usable
+            (void)link_program(vertex, fragment);
+
+            // Then linked in place rather than copied as a binary, which drivers need not
+            // support. The old shaders (if any are still attached) would clash with the new.
+            detach_all_shaders(_program.value());
+            link_program_into(_program.value(), vertex, fragment);
+        }
     }    // namespace shader_detail
 
     template<typename Vertex, typename Capabilities>
@@ -114,6 +148,11 @@ namespace randomcat::engine::graphics {
         return reinterpret_vertex<Vertex>();
     }
 
+    template<typename Vertex, typename Capabilities>
+    void shader<Vertex, Capabilities>::relink(std::string_view _vertex, std::string_view _fragment) noexcept(false) {
+        shader_detail::relink_program(program(), _vertex, _fragment);
+    }
+
     template<typename Vertex, typename Capabilities>
     template<typename NewVertex>
     shader<NewVertex, Capabilities> shader_view<Vertex, Capabilities>::reinterpret_vertex_and_inputs(std::vector<shader_input> _inputs) const noexcept {
@@ -136,6 +175,11 @@ namespace randomcat::engine::graphics {
         return reinterpret_vertex<Vertex>();
     }
 
+    template<typename Vertex, typename Capabilities>
+    void shader_view<Vertex, Capabilities>::relink(std::string_view _vertex, std::string_view _fragment) const noexcept(false) {
+        shader_detail::relink_program(program(), _vertex, _fragment);
+    }
+
     template<typename Capabilities>
     GLint shader_uniform_reader<Capabilities>::get_uniform_location(std::string const& _name) const {
         auto loc = glGetUniformLocation(program().value(), _name.c_str());
@@ -207,29 +251,42 @@ namespace randomcat::engine::graphics {
     void shader_uniform_writer<Capabilities>::set_bool(std::string const& _name, bool _value) const {
         auto l = this->make_active_lock();
         glUniform1i(this->get_uniform_location(_name), _value);
+        render_stats_detail::count_uniform_set();
     }
 
     template<typename Capabilities>
     void shader_uniform_writer<Capabilities>::set_int(std::string const& _name, GLint _value) const {
         auto l = this->make_active_lock();
         glUniform1i(this->get_uniform_location(_name), _value);
+        render_stats_detail::count_uniform_set();
     }
 
     template<typename Capabilities>
     void shader_uniform_writer<Capabilities>::set_float(std::string const& _name, GLfloat _value) const {
         auto l = this->make_active_lock();
         glUniform1f(this->get_uniform_location(_name), _value);
+        render_stats_detail::count_uniform_set();
     }
 
     template<typename Capabilities>
     void shader_uniform_writer<Capabilities>::set_vec3(std::string const& _name, glm::vec3 const& _value) const {
         auto l = this->make_active_lock();
         glUniform3fv(this->get_uniform_location(_name), 1, reinterpret_cast<GLfloat const*>(&_value));
+        render_stats_detail::count_uniform_set();
     }
 
     template<typename Capabilities>
     void shader_uniform_writer<Capabilities>::set_mat4(std::string const& _name, glm::mat4 const& _value) const {
         auto l = this->make_active_lock();
         glUniformMatrix4fv(this->get_uniform_location(_name), 1, false, reinterpret_cast<GLfloat const*>(&_value));
+        render_stats_detail::count_uniform_set();
+    }
+
+    template<typename Capabilities>
+    void shader_uniform_writer<Capabilities>::set_uniform_block_binding(std::string const& _name, GLuint _binding) const {
+        auto const index = glGetUniformBlockIndex(this->program().value(), _name.c_str());
+        if (index == GL_INVALID_INDEX) throw no_such_uniform_error("No such uniform block: " + _name);
+
+        glUniformBlockBinding(this->program().value(), index, _binding);
     }
 }    // namespace randomcat::engine::graphics
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include <GL/glew.h>
+
+namespace randomcat::engine::graphics {
+    // Collects GL debug output for a debug render_context. The driver may call back on any
+    // thread, often many times per frame with the same message, so the callback only
+    // counts the message in a fixed table keyed by source, type and id; it never blocks,
+    // allocates or logs. Once a frame, report logs each message the first time it is seen
+    // and a repeat count at most once a second after that, with at most
+    // reports_per_second log lines for each source and type. Messages over that limit
+    // are held back and reported later with their counts, so none are lost.
+    //
+    // Messages go to the "gl" log category, at error level for high severity, warn for
+    // medium and low, and info for notifications.
+    class gl_debug_messages {
+    public:
+        static auto constexpr capacity = std::size_t(256);
+        static auto constexpr max_message_length = std::size_t(256);
+        static auto constexpr reports_per_second = 5;
+
+        gl_debug_messages() noexcept(!"Allocates");
+
+        gl_debug_messages(gl_debug_messages const&) = delete;
+        gl_debug_messages(gl_debug_messages&&) = delete;
+
+        // Safe to call from any thread. Messages beyond the table's capacity are only counted.
+        void record(GLenum _source, GLenum _type, GLuint _id, GLenum _severity, std::string_view _message) noexcept;
+
+        // Call from one thread at a time; render_context::render calls it every frame
+        void report() noexcept;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct message_slot {
+            // Zero while free; the slot's owner is whoever sets it
+            std::atomic<std::uint64_t> key{0};
+            std::atomic<bool> ready{false};
+            std::atomic<std::uint32_t> pending{0};
+
+            GLenum source;
+            GLenum type;
+            GLuint id;
+            GLenum severity;
+            std::array<char, max_message_length> text;
+            std::size_t length;
+        };
+
+        // Only touched by report
+        struct slot_report_state {
+            bool announced = false;
+            std::int64_t unreported = 0;
+            clock::time_point lastReport;
+        };
+
+        struct rate_limit {
+            GLenum source;
+            GLenum type;
+            clock::time_point windowStart;
+            int reports;
+        };
+
+        [[nodiscard]] bool take_report(GLenum _source, GLenum _type, clock::time_point _now) noexcept(!"Allocates");
+
+        std::unique_ptr<std::array<message_slot, capacity>> m_slots;
+        std::atomic<std::int64_t> m_overflow{0};
+
+        std::vector<slot_report_state> m_reportStates;
+        std::vector<rate_limit> m_rateLimits;
+    };
+}    // namespace randomcat::engine::graphics
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/graphics/gl_wrappers/opengl_raii_id.hpp"
+
+namespace randomcat::engine::graphics::gl_detail {
+    [[nodiscard]] inline auto make_framebuffer() noexcept {
+        opengl_raw_id id;
+        glGenFramebuffers(1, &id);
+        return opengl_raw_id{id};
+    }
+
+    inline void destroy_framebuffer(opengl_raw_id _id) noexcept { glDeleteFramebuffers(1, &_id); }
+
+    using unique_framebuffer_id = unique_opengl_raii_id<make_framebuffer, destroy_framebuffer>;
+    using shared_framebuffer_id = shared_opengl_raii_id<make_framebuffer, destroy_framebuffer>;
+    using raw_framebuffer_id = unique_framebuffer_id::raw_id;
+
+    [[nodiscard]] inline auto make_renderbuffer() noexcept {
+        opengl_raw_id id;
+        glGenRenderbuffers(1, &id);
+        return opengl_raw_id{id};
+    }
+
+    inline void destroy_renderbuffer(opengl_raw_id _id) noexcept { glDeleteRenderbuffers(1, &_id); }
+
+    using unique_renderbuffer_id = unique_opengl_raii_id<make_renderbuffer, destroy_renderbuffer>;
+    using shared_renderbuffer_id = shared_opengl_raii_id<make_renderbuffer, destroy_renderbuffer>;
+    using raw_renderbuffer_id = unique_renderbuffer_id::raw_id;
+}    // namespace randomcat::engine::graphics::gl_detail
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/raii_active_lock.hpp"
+
+namespace randomcat::engine::graphics {
+    class gpu_profiler;
+
+    namespace gpu_profiler_detail {
+        inline thread_local gpu_profiler* g_activeProfiler = nullptr;
+
+        inline void set_active_profiler(gpu_profiler* _profiler) noexcept { g_activeProfiler = _profiler; }
+
+        [[nodiscard]] inline gpu_profiler* active_profiler() noexcept { return g_activeProfiler; }
+
+        struct scope_handle {
+            std::uint64_t frame;
+            std::size_t index;
+        };
+    }    // namespace gpu_profiler_detail
+
+    using gpu_profiler_active_lock = util_detail::basic_active_lock<gpu_profiler_detail::set_active_profiler, gpu_profiler_detail::active_profiler>;
+
+    struct gpu_scope_timing {
+        std::string name;
+        std::int64_t calls;
+
+        std::chrono::nanoseconds gpuTotal;
+        std::chrono::nanoseconds gpuMax;
+        std::chrono::nanoseconds cpuTotal;
+        std::chrono::nanoseconds cpuMax;
+    };
+
+    std::ostream& operator<<(std::ostream& _stream, gpu_scope_timing const& _timing) noexcept(!"Throws on stream error");
+
+    // Times named scopes on both the GPU (with GL_TIMESTAMP queries) and the CPU. Queries
+    // are kept in a ring of frames_in_flight frames and a frame's results are read when its
+    // slot comes round again, so reading them never waits for the GPU; a frame whose
+    // results are still not ready by then is dropped. Without ARB_timer_query, GPU times
+    // are zero.
+    //
+    // A profiler must be made active on the thread that renders for gpu_scopes there to
+    // record into it. render_context::render starts a frame on the active profiler.
+    // Construct and destroy with the context current.
+    class gpu_profiler {
+    public:
+        using time = std::chrono::nanoseconds;
+
+        static auto constexpr frames_in_flight = std::size_t(4);
+        static auto constexpr max_scopes_per_frame = std::size_t(256);
+
+        gpu_profiler() noexcept(!"Allocates");
+        ~gpu_profiler() noexcept;
+
+        gpu_profiler(gpu_profiler const&) = delete;
+        gpu_profiler(gpu_profiler&&) = delete;
+
+        [[nodiscard]] auto make_active_lock() noexcept { return gpu_profiler_active_lock(this); }
+
+        // Collects the results of the frame frames_in_flight frames ago and starts a new one
+        void begin_frame() noexcept;
+
+        // Totals over every collected frame, in the order the scopes were first seen
+        [[nodiscard]] std::vector<gpu_scope_timing> const& timings() const noexcept { return m_timings; }
+
+        // Scopes beyond max_scopes_per_frame in one frame, and frames whose results were not ready
+        [[nodiscard]] std::int64_t dropped_scopes() const noexcept { return m_droppedScopes; }
+        [[nodiscard]] std::int64_t dropped_frames() const noexcept { return m_droppedFrames; }
+
+        // Zeroes the totals, keeping the scope names
+        void reset() noexcept;
+
+        // Used by gpu_scope
+        [[nodiscard]] gpu_profiler_detail::scope_handle begin_scope(std::string_view _name) noexcept;
+        void end_scope(gpu_profiler_detail::scope_handle _handle) noexcept;
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        static auto constexpr no_scope = std::numeric_limits<std::size_t>::max();
+
+        struct pending_scope {
+            std::size_t timing;
+            clock::time_point cpuBegin;
+            clock::time_point cpuEnd;
+            bool ended;
+        };
+
+        struct frame_slot {
+            std::uint64_t frame = 0;
+            std::vector<pending_scope> scopes;
+
+            // Queries complete in order, so once this one has a result they all do
+            GLuint lastQuery = 0;
+        };
+
+        [[nodiscard]] frame_slot& current_slot() noexcept { return m_slots[m_frame % frames_in_flight]; }
+        [[nodiscard]] GLuint query(std::uint64_t _frame, std::size_t _scope, bool _end) const noexcept;
+        [[nodiscard]] std::size_t timing_index(std::string_view _name) noexcept;
+
+        void collect(frame_slot& _slot) noexcept;
+
+        bool m_hasTimerQueries;
+        std::vector<GLuint> m_queries;
+        std::vector<frame_slot> m_slots;
+        std::uint64_t m_frame = 0;
+
+        std::vector<gpu_scope_timing> m_timings;
+        std::int64_t m_droppedScopes = 0;
+        std::int64_t m_droppedFrames = 0;
+    };
+
+    // Times the enclosing scope under _name in the active profiler, if there is one;
+    // otherwise does nothing. Scopes may nest.
+    class gpu_scope {
+    public:
+        explicit gpu_scope(std::string_view _name) noexcept : m_profiler(gpu_profiler_detail::active_profiler()) {
+            if (m_profiler) m_handle = m_profiler->begin_scope(_name);
+        }
+
+        ~gpu_scope() noexcept {
+            if (m_profiler) m_profiler->end_scope(m_handle);
+        }
+
+        gpu_scope(gpu_scope const&) = delete;
+        gpu_scope(gpu_scope&&) = delete;
+
+    private:
+        gpu_profiler* m_profiler;
+        gpu_profiler_detail::scope_handle m_handle{};
+    };
+
+    namespace gpu_profiler_detail {
+        inline void begin_active_frame() noexcept {
+            if (auto const profiler = active_profiler()) profiler->begin_frame();
+        }
+    }    // namespace gpu_profiler_detail
+}    // namespace randomcat::engine::graphics
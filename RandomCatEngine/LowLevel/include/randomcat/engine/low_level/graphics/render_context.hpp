@@ -1,9 +1,19 @@
 #pragma once
 
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include <SDL2/SDL_video.h>
 
 #include "randomcat/engine/low_level/detail/raii_active_lock.hpp"
+#include "randomcat/engine/low_level/graphics/gl_debug_messages.hpp"
+#include "randomcat/engine/low_level/graphics/gl_wrappers/framebuffer_raii.hpp"
 #include "randomcat/engine/low_level/graphics/global_gl_calls.hpp"
+#include "randomcat/engine/low_level/graphics/gpu_profiler.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
+#include "randomcat/engine/low_level/profiling.hpp"
 #include "randomcat/engine/low_level/window.hpp"
 
 namespace randomcat::engine::graphics {
@@ -11,16 +21,22 @@ namespace randomcat::engine::graphics {
         struct context_data {
             SDL_Window* window;
             SDL_GLContext context;
+
+            // Set instead of window and context for headless contexts (EGLDisplay and EGLContext)
+            void* eglDisplay;
+            void* eglContext;
         };
 
-        inline void activate_context(context_data _context) noexcept { SDL_GL_MakeCurrent(_context.window, _context.context); }
+        void activate_context(context_data _context) noexcept;
 
-        inline context_data current_context() noexcept { return context_data{SDL_GL_GetCurrentWindow(), SDL_GL_GetCurrentContext()}; }
+        context_data current_context() noexcept;
 
         struct render_context_init_error_tag {};
+        struct render_context_error_tag {};
     }    // namespace render_context_detail
 
     using render_context_init_error = util_detail::tag_exception<render_context_detail::render_context_init_error_tag>;
+    using render_context_error = util_detail::tag_exception<render_context_detail::render_context_error_tag>;
 
     using render_context_active_lock = util_detail::basic_active_lock<render_context_detail::activate_context, render_context_detail::current_context>;
 
@@ -33,20 +49,82 @@ namespace randomcat::engine::graphics {
 
         explicit render_context(window const& _window, flags _flags = flags::none) noexcept(!"Throws on error");
 
+        // A context without a window, e.g. for benchmarks and image tests on machines without
+        // a display. It renders to an offscreen framebuffer of the given size through an
+        // OpenGL 3.3 core EGL context (surfaceless, so Mesa's llvmpipe works). Requires
+        // building with RC_ENGINE_HEADLESS.
+        struct headless_t {};
+        static auto constexpr headless = headless_t{};
+        explicit render_context(headless_t, std::int16_t _width, std::int16_t _height, flags _flags = flags::none) noexcept(!"Throws on error");
+
+        ~render_context() noexcept;
+
+        render_context(render_context const&) = delete;
+        render_context(render_context&&) = delete;
+
         auto make_active_lock() const noexcept { return render_context_active_lock(m_context); }
 
+        // Each call is a frame for the active gpu_profiler, if any, and for render_stats. GL debug
+        // messages received since the last frame are logged at its end.
         template<typename F, typename... Args>
         void render(F&& _f, Args&&... _args) const noexcept {
+            RC_PROFILE_SCOPE("render_context::render");
+
             auto l = make_active_lock();
-            clear_graphics();
-            std::forward<F>(_f)(std::forward<Args>(_args)...);
+            gpu_profiler_detail::begin_active_frame();
+
+            {
+                auto scope = gpu_scope("render");
+                bind_render_target();
+                clear_graphics();
+                std::forward<F>(_f)(std::forward<Args>(_args)...);
+            }
+
+            RC_PROFILE_SCOPE("swap buffers");
+            auto scope = gpu_scope("swap buffers");
             swap_buffers();
+
+            if (m_debugMessages) m_debugMessages->report();
+            render_stats_detail::end_frame();
         }
 
+        // Wraps glDebugMessageControl; GL_DONT_CARE matches anything. Notifications are
+        // disabled when a debug context is created. Does nothing without flags::debug.
+        void set_debug_messages_enabled(GLenum _source, GLenum _type, GLenum _severity, bool _enabled) const noexcept;
+
+        [[nodiscard]] bool is_headless() const noexcept { return m_offscreen.has_value(); }
+
+        // The last rendered frame of a headless context as RGBA, 4 bytes per pixel, bottom row first
+        [[nodiscard]] std::vector<std::uint8_t> read_pixels() const noexcept(!"Throws if not headless");
+
     private:
-        void swap_buffers() const noexcept { SDL_GL_SwapWindow(m_context.window); }
+        struct offscreen_target {
+            gl_detail::unique_framebuffer_id framebuffer;
+            gl_detail::unique_renderbuffer_id color;
+            gl_detail::unique_renderbuffer_id depth;
+
+            std::int16_t width;
+            std::int16_t height;
+        };
+
+        void bind_render_target() const noexcept {
+            if (m_offscreen) glBindFramebuffer(GL_FRAMEBUFFER, m_offscreen->framebuffer.value());
+        }
+
+        void swap_buffers() const noexcept {
+            // Nothing is presented, so wait for the frame instead so that frame times include its rendering
+            if (m_offscreen) {
+                glFinish();
+            } else {
+                SDL_GL_SwapWindow(m_context.window);
+            }
+        }
 
         render_context_detail::context_data m_context;
+        std::optional<offscreen_target> m_offscreen;
+
+        // Only for debug contexts. Boxed, as the GL holds its address.
+        std::unique_ptr<gl_debug_messages> m_debugMessages;
     };
 
     inline auto __underlying(render_context::flags f) noexcept { return static_cast<std::underlying_type_t<decltype(f)>>(f); }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace randomcat::engine::graphics {
+    // What the engine asked of the GL, counted at the engine's own call sites. GL work done
+    // directly by game code is not counted.
+    struct render_stats {
+        std::int64_t drawCalls = 0;
+        std::int64_t verticesUploaded = 0;
+        std::int64_t vertexBytesUploaded = 0;
+
+        // VAO, VBO and program binds made by the active locks, including those that restore
+        // the previous binding when a lock ends
+        std::int64_t stateBinds = 0;
+
+        std::int64_t uniformSets = 0;
+        std::int64_t textureUploads = 0;
+        std::int64_t textureBytesUploaded = 0;
+        std::int64_t shaderCompiles = 0;
+
+        // Messages from the GL debug output of a debug render_context, counted when they
+        // are reported rather than when the driver sent them
+        std::int64_t debugMessages = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& _stream, render_stats const& _stats) noexcept(!"Throws on stream error");
+
+    namespace render_stats_detail {
+        // Per thread, as GL contexts are
+        inline thread_local render_stats g_currentFrame{};
+        inline thread_local render_stats g_lastFrame{};
+
+        inline void count_draw(std::size_t _vertices, std::size_t _bytes) noexcept {
+            ++g_currentFrame.drawCalls;
+            g_currentFrame.verticesUploaded += std::int64_t(_vertices);
+            g_currentFrame.vertexBytesUploaded += std::int64_t(_bytes);
+        }
+
+        inline void count_state_bind() noexcept { ++g_currentFrame.stateBinds; }
+
+        inline void count_uniform_set() noexcept { ++g_currentFrame.uniformSets; }
+
+        inline void count_texture_upload(std::size_t _bytes) noexcept {
+            ++g_currentFrame.textureUploads;
+            g_currentFrame.textureBytesUploaded += std::int64_t(_bytes);
+        }
+
+        inline void count_shader_compile() noexcept { ++g_currentFrame.shaderCompiles; }
+
+        inline void count_debug_messages(std::int64_t _count) noexcept { g_currentFrame.debugMessages += _count; }
+
+        // Called by render_context::render once the frame is presented
+        inline void end_frame() noexcept {
+            g_lastFrame = g_currentFrame;
+            g_currentFrame = render_stats{};
+        }
+    }    // namespace render_stats_detail
+
+    // A frame runs from the end of one render_context::render on this thread to the end of
+    // the next, so work done between renders (loading, hot reloads) counts towards the
+    // frame that follows it.
+    [[nodiscard]] inline render_stats const& last_frame_render_stats() noexcept { return render_stats_detail::g_lastFrame; }
+
+    // The frame in progress, so far
+    [[nodiscard]] inline render_stats const& current_frame_render_stats() noexcept { return render_stats_detail::g_currentFrame; }
+}    // namespace randomcat::engine::graphics
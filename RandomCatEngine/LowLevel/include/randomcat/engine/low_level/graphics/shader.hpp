@@ -10,8 +10,10 @@
 #include "randomcat/engine/low_level/detail/tag_exception.hpp"
 #include "randomcat/engine/low_level/graphics/gl_wrappers/active_locks.hpp"
 #include "randomcat/engine/low_level/graphics/gl_wrappers/shader_program_raii.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
 #include "randomcat/engine/low_level/graphics/shader_input.hpp"
 #include "randomcat/engine/low_level/graphics/shader_uniforms.hpp"
+#include "randomcat/engine/low_level/profiling.hpp"
 
 namespace randomcat::engine::graphics {
     namespace shader_detail {
@@ -65,6 +67,11 @@ namespace randomcat::engine::graphics {
 
         [[nodiscard]] shader clone() const noexcept;
 
+        // Recompiles the program in place, so every shader and shader_view sharing it sees
+        // the change. Throws shader_init_error and leaves the program untouched if the
+        // sources do not compile or link. Uniforms are reset to their defaults.
+        void relink(std::string_view _vertex, std::string_view _fragment) noexcept(!"Throws on error");
+
         template<typename Func>
         [[nodiscard]] decltype(auto) uniforms_as(Func&& _func) noexcept(noexcept(uniforms().template as(std::forward<Func>(_func)))) {
             return uniforms().template as(std::forward<Func>(_func));
@@ -137,6 +144,9 @@ namespace randomcat::engine::graphics {
 
         [[nodiscard]] shader<Vertex, UniformCapabilities> clone() const noexcept;
 
+        // As shader::relink
+        void relink(std::string_view _vertex, std::string_view _fragment) const noexcept(!"Throws on error");
+
         template<typename Func>
         [[nodiscard]] decltype(auto) uniforms_as(Func&& _func) const noexcept(noexcept(uniforms().template as(std::forward<Func>(_func)))) {
             return const_uniforms().template as(std::forward<Func>(_func));
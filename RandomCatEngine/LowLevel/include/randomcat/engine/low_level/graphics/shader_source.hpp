@@ -0,0 +1,15 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace randomcat::engine::graphics {
+    // Returns _source with _declarations inserted straight after its #version line, which
+    // is raised to _minimumVersion if it asks for less (keeping any profile). Returns
+    // nullopt if _source does not start with a #version line, optionally preceded by
+    // whitespace.
+    [[nodiscard]] std::optional<std::string> insert_shader_declarations(std::string_view _source,
+                                                                        std::string_view _declarations,
+                                                                        int _minimumVersion = 0) noexcept(!"Allocates");
+}    // namespace randomcat::engine::graphics
@@ -106,6 +106,9 @@ namespace randomcat::engine::graphics {
         void set_vec3(std::string const& _name, glm::tvec3<GLfloat> const& _value) const noexcept(!"Throws if uniform not found");
         void set_mat4(std::string const& _name, glm::tmat4x4<GLfloat> const& _value) const noexcept(!"Throws if uniform not found");
 
+        // Throws shader_no_such_uniform_error if the referenced uniform block does not exist
+        void set_uniform_block_binding(std::string const& _name, GLuint _binding) const noexcept(!"Throws if uniform block not found");
+
         template<typename Wrapper, typename = std::enable_if_t<has_capability<Wrapper>>>
         [[nodiscard]] Wrapper as() const noexcept(noexcept(Wrapper(*this))) {
             return Wrapper(*this);
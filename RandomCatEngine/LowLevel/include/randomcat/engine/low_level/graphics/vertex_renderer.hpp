@@ -6,7 +6,10 @@
 
 #include "randomcat/engine/low_level/graphics/gl_wrappers/vao_raii.hpp"
 #include "randomcat/engine/low_level/graphics/gl_wrappers/vbo_raii.hpp"
+#include "randomcat/engine/low_level/graphics/gpu_profiler.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
 #include "randomcat/engine/low_level/graphics/shader.hpp"
+#include "randomcat/engine/low_level/profiling.hpp"
 
 // I must put definitions here because of stupid C++ template rules.
 
@@ -51,6 +54,8 @@ namespace randomcat::engine::graphics {
 
         template<typename T>
         void operator()(T const& _t) const noexcept {
+            RC_PROFILE_SCOPE("vertex_renderer");
+
             auto l = make_active_lock();
             render_active(_t);
         }
@@ -93,8 +98,15 @@ namespace randomcat::engine::graphics {
 
         template<typename _container_t, typename = std::enable_if_t<is_vertex_container_v<_container_t>>>
         void render_active(_container_t const& _vertices) const noexcept {
-            glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(vertex), _vertices.data(), GL_DYNAMIC_DRAW);
+            {
+                auto scope = gpu_scope("vertex upload");
+                glBufferData(GL_ARRAY_BUFFER, _vertices.size() * sizeof(vertex), _vertices.data(), GL_DYNAMIC_DRAW);
+            }
+
+            auto scope = gpu_scope("draw");
             glDrawArrays(GL_TRIANGLES, 0, _vertices.size());
+
+            render_stats_detail::count_draw(_vertices.size(), _vertices.size() * sizeof(vertex));
         }
 
         gl_detail::unique_vao_id m_vao;
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+
+#include <randomcat/util/require_filesystem.hpp>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+
+#if RC_ENGINE_PROFILING
+#    include <array>
+#    include <atomic>
+#    include <chrono>
+#    include <cstddef>
+#    include <cstdint>
+#    include <memory>
+#    include <vector>
+#endif
+
+// CPU zones for finding where frame time goes. RC_PROFILE_SCOPE("name") times the rest of
+// the enclosing scope into a ring buffer owned by the calling thread, which keeps the
+// most recent zones; write_chrome_trace dumps them as Chrome trace-event JSON, which
+// Perfetto (ui.perfetto.dev) and chrome://tracing can open.
+//
+// Unless built with RC_ENGINE_PROFILING, RC_PROFILE_SCOPE expands to nothing and the
+// trace is empty.
+
+namespace randomcat::engine::profiling {
+#if RC_ENGINE_PROFILING
+    static auto constexpr enabled = true;
+#else
+    static auto constexpr enabled = false;
+#endif
+
+    namespace profiling_detail {
+        struct profiling_error_tag {};
+    }    // namespace profiling_detail
+
+    using profiling_error = util_detail::tag_exception<profiling_detail::profiling_error_tag>;
+
+    // Writes every zone still in a ring buffer, from all threads that have recorded any.
+    // May be called while other threads are recording.
+    void write_chrome_trace(std::ostream& _stream) noexcept(!"Throws on stream error");
+    void write_chrome_trace(fs::path const& _path) noexcept(!"Throws on error");
+
+    // Names the calling thread in traces
+    void set_thread_name(std::string _name) noexcept(!"Allocates");
+
+#if RC_ENGINE_PROFILING
+    namespace profiling_detail {
+        using clock = std::chrono::steady_clock;
+
+        [[nodiscard]] inline std::int64_t now() noexcept {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        }
+
+        // Fields are atomic only so that the exporter may read a slot while it is rewritten
+        struct zone_event {
+            std::atomic<char const*> name;
+            std::atomic<std::int64_t> begin;
+            std::atomic<std::int64_t> end;
+        };
+
+        // Written only by its thread. A reader copies the slots below m_written, then
+        // discards any that m_claimed shows may have been overwritten during the copy.
+        class thread_buffer {
+        public:
+            static auto constexpr capacity = std::size_t(1) << 16;
+
+            explicit thread_buffer(std::uint32_t _threadID) noexcept(!"Allocates")
+            : m_events(std::make_unique<std::array<zone_event, capacity>>()), m_threadID(_threadID) {}
+
+            void record(char const* _name, std::int64_t _begin, std::int64_t _end) noexcept {
+                auto const index = m_written.load(std::memory_order_relaxed);
+
+                m_claimed.store(index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                auto& event = (*m_events)[index % capacity];
+                event.name.store(_name, std::memory_order_relaxed);
+                event.begin.store(_begin, std::memory_order_relaxed);
+                event.end.store(_end, std::memory_order_relaxed);
+
+                m_written.store(index + 1, std::memory_order_release);
+            }
+
+            struct zone {
+                char const* name;
+                std::int64_t begin;
+                std::int64_t end;
+            };
+
+            // Appends the zones still in the buffer, oldest first
+            void copy_zones(std::vector<zone>& _zones) const noexcept(!"Allocates");
+
+            [[nodiscard]] auto thread_id() const noexcept { return m_threadID; }
+
+        private:
+            std::unique_ptr<std::array<zone_event, capacity>> m_events;
+            std::atomic<std::uint64_t> m_written{0};
+            std::atomic<std::uint64_t> m_claimed{0};
+            std::uint32_t m_threadID;
+        };
+
+        // Registers the calling thread's buffer, which lives until the program exits so
+        // that zones from finished threads can still be exported
+        [[nodiscard]] thread_buffer& register_thread() noexcept(!"Allocates");
+
+        inline thread_local thread_buffer* g_threadBuffer = nullptr;
+
+        [[nodiscard]] inline thread_buffer& this_thread_buffer() noexcept(!"Allocates") {
+            if (!g_threadBuffer) g_threadBuffer = &register_thread();
+            return *g_threadBuffer;
+        }
+    }    // namespace profiling_detail
+
+    class profile_scope {
+    public:
+        // _name must outlive the trace; RC_PROFILE_SCOPE only accepts string literals. The
+        // first scope on a thread registers its buffer, so that the destructor cannot throw.
+        explicit profile_scope(char const* _name) noexcept(!"Allocates")
+        : m_buffer(profiling_detail::this_thread_buffer()), m_name(_name), m_begin(profiling_detail::now()) {}
+
+        ~profile_scope() noexcept { m_buffer.record(m_name, m_begin, profiling_detail::now()); }
+
+        profile_scope(profile_scope const&) = delete;
+        profile_scope(profile_scope&&) = delete;
+
+    private:
+        profiling_detail::thread_buffer& m_buffer;
+        char const* m_name;
+        std::int64_t m_begin;
+    };
+#endif
+}    // namespace randomcat::engine::profiling
+
+#if RC_ENGINE_PROFILING
+#    define RC_PROFILE_CONCAT_IMPL(a, b) a##b
+#    define RC_PROFILE_CONCAT(a, b) RC_PROFILE_CONCAT_IMPL(a, b)
+
+// Pasting "" around the name rejects anything but a string literal
+#    define RC_PROFILE_SCOPE(name)                                                                                                                 \
+        ::randomcat::engine::profiling::profile_scope const RC_PROFILE_CONCAT(rc_profile_scope_, __LINE__) { "" name "" }
+#else
+#    define RC_PROFILE_SCOPE(name) static_cast<void>(0)
+#endif
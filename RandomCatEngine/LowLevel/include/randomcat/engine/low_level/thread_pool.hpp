@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace randomcat::engine {
+    // A fixed set of worker threads for splitting per-frame work, so that threads are not
+    // started every frame. The thread calling run works alongside the workers.
+    class thread_pool {
+    public:
+        // Enough workers that, with the calling thread, every hardware thread is used
+        [[nodiscard]] static std::size_t default_worker_count() noexcept;
+
+        explicit thread_pool(std::size_t _workerCount = default_worker_count()) noexcept(!"Starts threads");
+        ~thread_pool() noexcept;
+
+        thread_pool(thread_pool const&) = delete;
+        thread_pool(thread_pool&&) = delete;
+
+        thread_pool& operator=(thread_pool const&) = delete;
+        thread_pool& operator=(thread_pool&&) = delete;
+
+        // The number of threads that run uses, including the calling thread
+        [[nodiscard]] std::size_t thread_count() const noexcept { return m_workers.size() + 1; }
+
+        // Calls _task(i) for each i in [0, _count), each exactly once, in no particular
+        // order and on any of the pool's threads or the calling thread. Returns once every
+        // call has returned. Calls to run from different threads take turns; calling run
+        // from within a task deadlocks.
+        template<typename F>
+        void run(std::size_t _count, F&& _task) noexcept {
+            static_assert(std::is_nothrow_invocable_v<F&, std::size_t>, "Tasks must not throw");
+
+            using task_type = std::remove_reference_t<F>;
+
+            run_tasks(_count, std::addressof(_task), [](void const* _context, std::size_t _index) noexcept {
+                (*static_cast<task_type*>(const_cast<void*>(_context)))(_index);
+            });
+        }
+
+    private:
+        using task_function = void (*)(void const*, std::size_t) noexcept;
+
+        void run_tasks(std::size_t _count, void const* _context, task_function _function) noexcept;
+
+        void stop() noexcept;
+
+        void run_worker() noexcept;
+
+        // Claims and runs tasks of the current run until there are none left
+        void work() noexcept;
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_runMutex;    // Held for the whole of a run
+
+        // Guards all below, except m_nextTask. The current run's task is only written
+        // while no worker is busy.
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+
+        std::uint64_t m_generation = 0;    // Incremented for each run
+        std::size_t m_busyWorkers = 0;
+        bool m_stopping = false;
+
+        std::size_t m_taskCount = 0;
+        void const* m_taskContext = nullptr;
+        task_function m_taskFunction = nullptr;
+        std::atomic<std::size_t> m_nextTask{0};
+    };
+}    // namespace randomcat::engine
@@ -0,0 +1,272 @@
+#include "randomcat/engine/low_level/binary_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iomanip>
+
+namespace randomcat::engine::log {
+    namespace {
+        auto constexpr magic = std::array<char, 4>{'R', 'C', 'B', 'L'};
+        auto constexpr format_version = std::uint32_t(1);
+
+        enum class entry_tag : std::uint8_t { string = 0, record = 1 };
+
+        // Same order as log_field_value and decoded_field_value
+        enum class value_tag : std::uint8_t { boolean = 0, integer = 1, floating = 2, string = 3 };
+
+        template<typename Integer>
+        void write_fixed(std::vector<char>& _buffer, Integer _value) noexcept(false) {
+            using unsigned_type = std::make_unsigned_t<Integer>;
+            auto const value = unsigned_type(_value);
+
+            for (std::size_t i = 0; i < sizeof(Integer); ++i) _buffer.push_back(char((value >> (8 * i)) & 0xFF));
+        }
+
+        void write_varint(std::vector<char>& _buffer, std::uint64_t _value) noexcept(false) {
+            while (_value >= 0x80) {
+                _buffer.push_back(char((_value & 0x7F) | 0x80));
+                _value >>= 7;
+            }
+
+            _buffer.push_back(char(_value));
+        }
+
+        void write_signed_varint(std::vector<char>& _buffer, std::int64_t _value) noexcept(false) {
+            // Zigzag, so that small negative values stay short
+            write_varint(_buffer, (std::uint64_t(_value) << 1) ^ std::uint64_t(_value >> 63));
+        }
+
+        void write_bytes(std::vector<char>& _buffer, std::string_view _bytes) noexcept(false) {
+            write_varint(_buffer, _bytes.size());
+            _buffer.insert(end(_buffer), begin(_bytes), end(_bytes));
+        }
+
+        template<typename Integer>
+        [[nodiscard]] Integer read_fixed(std::istream& _stream) noexcept(false) {
+            using unsigned_type = std::make_unsigned_t<Integer>;
+
+            std::array<char, sizeof(Integer)> bytes;
+            if (!_stream.read(bytes.data(), bytes.size())) throw binary_log_error{"Binary log is truncated"};
+
+            auto value = unsigned_type(0);
+            for (std::size_t i = 0; i < bytes.size(); ++i) value |= unsigned_type(unsigned_type(std::uint8_t(bytes[i])) << (8 * i));
+
+            return Integer(value);
+        }
+
+        [[nodiscard]] std::uint8_t read_byte(std::istream& _stream) noexcept(false) { return read_fixed<std::uint8_t>(_stream); }
+
+        [[nodiscard]] std::uint64_t read_varint(std::istream& _stream) noexcept(false) {
+            auto value = std::uint64_t(0);
+
+            for (auto shift = 0; shift < 64; shift += 7) {
+                auto const byte = read_byte(_stream);
+                value |= std::uint64_t(byte & 0x7F) << shift;
+
+                if (!(byte & 0x80)) return value;
+            }
+
+            throw binary_log_error{"Binary log has an overlong integer"};
+        }
+
+        [[nodiscard]] std::int64_t read_signed_varint(std::istream& _stream) noexcept(false) {
+            auto const value = read_varint(_stream);
+            return std::int64_t(value >> 1) ^ -std::int64_t(value & 1);
+        }
+
+        [[nodiscard]] std::string read_bytes(std::istream& _stream) noexcept(false) {
+            auto const size = read_varint(_stream);
+
+            // Read in pieces, so that a corrupt size fails on truncation rather than allocating
+            std::string result;
+            std::array<char, 4096> piece;
+
+            for (auto remaining = size; remaining > 0;) {
+                auto const count = std::min<std::uint64_t>(remaining, piece.size());
+                if (!_stream.read(piece.data(), std::streamsize(count))) throw binary_log_error{"Binary log is truncated"};
+
+                result.append(piece.data(), count);
+                remaining -= count;
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] std::string const& string_at(std::vector<std::string> const& _strings, std::uint64_t _index) noexcept(false) {
+            if (_index >= _strings.size()) throw binary_log_error{"Binary log refers to an undefined string"};
+            return _strings[_index];
+        }
+    }    // namespace
+
+    binary_log_writer::binary_log_writer(fs::path const& _path) noexcept(false)
+    : m_stream(_path, std::ios::binary | std::ios::trunc), m_start(clock::now()) {
+        if (!m_stream) throw binary_log_error{"Unable to open binary log for writing: " + _path.string()};
+
+        auto const startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
+
+        m_stream.write(magic.data(), magic.size());
+        write_fixed(m_buffer, format_version);
+        write_fixed(m_buffer, std::int64_t(startTime.count()));
+        m_stream.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+        m_buffer.clear();
+
+        if (!m_stream) throw binary_log_error{"Unable to write binary log: " + _path.string()};
+    }
+
+    std::uint64_t binary_log_writer::string_index(std::string_view _string) noexcept(false) {
+        // There are only ever a handful of distinct event names and keys
+        auto const existing = std::find(begin(m_strings), end(m_strings), _string);
+        if (existing != end(m_strings)) return std::uint64_t(existing - begin(m_strings));
+
+        // Defined ahead of the record being encoded, which refers to it
+        std::vector<char> definition;
+        definition.push_back(char(entry_tag::string));
+        write_bytes(definition, _string);
+        m_stream.write(definition.data(), std::streamsize(definition.size()));
+
+        m_strings.emplace_back(_string);
+        return m_strings.size() - 1;
+    }
+
+    void binary_log_writer::write(std::string_view _event, std::initializer_list<log_field> _fields) noexcept(false) {
+        auto const time = clock::now() - m_start;
+
+        m_buffer.clear();
+        m_buffer.push_back(char(entry_tag::record));
+        write_varint(m_buffer, std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(time - m_lastTime).count()));
+        write_varint(m_buffer, string_index(_event));
+        write_varint(m_buffer, _fields.size());
+
+        for (auto const& field : _fields) {
+            write_varint(m_buffer, string_index(field.key));
+            m_buffer.push_back(char(field.value.index()));
+
+            std::visit(
+                [&](auto const& _value) {
+                    using value_type = std::decay_t<decltype(_value)>;
+
+                    if constexpr (std::is_same_v<value_type, bool>) {
+                        m_buffer.push_back(char(_value));
+                    } else if constexpr (std::is_same_v<value_type, std::int64_t>) {
+                        write_signed_varint(m_buffer, _value);
+                    } else if constexpr (std::is_same_v<value_type, double>) {
+                        std::uint64_t bits;
+                        std::memcpy(&bits, &_value, sizeof(bits));
+                        write_fixed(m_buffer, bits);
+                    } else {
+                        write_bytes(m_buffer, _value);
+                    }
+                },
+                field.value);
+        }
+
+        m_stream.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+        m_lastTime = time;
+
+        if (!m_stream) throw binary_log_error{"Unable to write binary log"};
+    }
+
+    void binary_log_writer::flush() noexcept(false) {
+        if (!m_stream.flush()) throw binary_log_error{"Unable to write binary log"};
+    }
+
+    binary_log_reader::binary_log_reader(fs::path const& _path) noexcept(false) : m_stream(_path, std::ios::binary) {
+        if (!m_stream) throw binary_log_error{"Unable to open binary log: " + _path.string()};
+
+        std::array<char, magic.size()> fileMagic;
+        if (!m_stream.read(fileMagic.data(), fileMagic.size()) || fileMagic != magic) {
+            throw binary_log_error{"Not a binary log: " + _path.string()};
+        }
+
+        if (auto const version = read_fixed<std::uint32_t>(m_stream); version != format_version) {
+            throw binary_log_error{"Unsupported binary log version " + std::to_string(version)};
+        }
+
+        m_startTime = std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(read_fixed<std::int64_t>(m_stream))));
+    }
+
+    std::optional<decoded_record> binary_log_reader::read_record() noexcept(false) {
+        while (true) {
+            auto const tag = m_stream.get();
+            if (tag == std::ifstream::traits_type::eof()) return std::nullopt;
+
+            switch (entry_tag(tag)) {
+                case entry_tag::string: {
+                    m_strings.push_back(read_bytes(m_stream));
+                    continue;
+                }
+
+                case entry_tag::record: {
+                    m_lastTime += std::chrono::nanoseconds(read_varint(m_stream));
+
+                    auto record = decoded_record{m_lastTime, string_at(m_strings, read_varint(m_stream)), {}};
+
+                    auto const fieldCount = read_varint(m_stream);
+
+                    for (std::uint64_t i = 0; i < fieldCount; ++i) {
+                        auto key = string_at(m_strings, read_varint(m_stream));
+
+                        switch (value_tag(read_byte(m_stream))) {
+                            case value_tag::boolean: {
+                                record.fields.push_back(decoded_field{std::move(key), decoded_field_value(std::in_place_type<bool>, read_byte(m_stream) != 0)});
+                                break;
+                            }
+
+                            case value_tag::integer: {
+                                record.fields.push_back(
+                                    decoded_field{std::move(key), decoded_field_value(std::in_place_type<std::int64_t>, read_signed_varint(m_stream))});
+                                break;
+                            }
+
+                            case value_tag::floating: {
+                                auto const bits = read_fixed<std::uint64_t>(m_stream);
+                                double value;
+                                std::memcpy(&value, &bits, sizeof(value));
+
+                                record.fields.push_back(decoded_field{std::move(key), decoded_field_value(std::in_place_type<double>, value)});
+                                break;
+                            }
+
+                            case value_tag::string: {
+                                record.fields.push_back(decoded_field{std::move(key), decoded_field_value(std::in_place_type<std::string>, read_bytes(m_stream))});
+                                break;
+                            }
+
+                            default: throw binary_log_error{"Binary log has a field of unknown type"};
+                        }
+                    }
+
+                    return record;
+                }
+
+                default: throw binary_log_error{"Binary log has an entry of unknown type"};
+            }
+        }
+    }
+
+    std::ostream& operator<<(std::ostream& _stream, decoded_record const& _record) noexcept(false) {
+        _stream << std::chrono::duration<double, std::milli>(_record.time).count() << " " << _record.event;
+
+        for (auto const& field : _record.fields) {
+            _stream << " " << field.key << "=";
+
+            std::visit(
+                [&](auto const& _value) {
+                    using value_type = std::decay_t<decltype(_value)>;
+
+                    if constexpr (std::is_same_v<value_type, bool>) {
+                        _stream << (_value ? "true" : "false");
+                    } else if constexpr (std::is_same_v<value_type, std::string>) {
+                        _stream << std::quoted(_value);
+                    } else {
+                        _stream << _value;
+                    }
+                },
+                field.value);
+        }
+
+        return _stream;
+    }
+}    // namespace randomcat::engine::log
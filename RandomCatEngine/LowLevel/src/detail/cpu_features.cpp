@@ -0,0 +1,11 @@
+#include "randomcat/engine/low_level/detail/cpu_features.hpp"
+
+#include <SDL2/SDL_cpuinfo.h>
+
+namespace randomcat::engine::util_detail {
+    cpu_features const& detected_cpu_features() noexcept {
+        // SDL_Has* only read cached CPUID results, and do not require SDL_Init
+        static auto const features = cpu_features{SDL_HasSSE2() == SDL_TRUE, SDL_HasSSSE3() == SDL_TRUE, SDL_HasAVX2() == SDL_TRUE};
+        return features;
+    }
+}    // namespace randomcat::engine::util_detail
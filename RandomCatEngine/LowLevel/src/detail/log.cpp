@@ -0,0 +1,390 @@
+#include "randomcat/engine/low_level/detail/log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace randomcat::engine::log {
+    namespace {
+        using std::string_view_literals::operator""sv;
+
+        auto constexpr truncation_marker = "<TRUNCATED>"sv;
+        auto constexpr continuation_header = "\n[CONT] "sv;
+
+        // Formats into a fixed array, so that formatting never allocates. Output beyond the
+        // array is replaced with truncation_marker.
+        class format_buffer : public std::streambuf {
+        public:
+            static auto constexpr capacity = std::size_t(4096);
+
+            format_buffer() noexcept { reset(); }
+
+            void reset() noexcept {
+                // The end of the array is kept for the marker
+                setp(m_data.data(), m_data.data() + capacity - truncation_marker.size());
+                m_truncated = false;
+            }
+
+            [[nodiscard]] std::string_view text() const noexcept { return std::string_view(m_data.data(), std::size_t(pptr() - m_data.data())); }
+
+        protected:
+            int_type overflow(int_type _char) override {
+                if (!traits_type::eq_int_type(_char, traits_type::eof()) && !m_truncated) {
+                    m_truncated = true;
+
+                    auto* const marker = pptr();
+                    setp(marker, marker + truncation_marker.size());
+                    std::copy(begin(truncation_marker), end(truncation_marker), marker);
+                    pbump(int(truncation_marker.size()));
+                }
+
+                return traits_type::eof();
+            }
+
+        private:
+            std::array<char, capacity> m_data;
+            bool m_truncated = false;
+        };
+
+        struct thread_formatter {
+            format_buffer buffer;
+            std::ostream stream{&buffer};
+            std::ios_base::fmtflags defaultFlags = stream.flags();
+            std::streamsize defaultPrecision = stream.precision();
+        };
+
+        thread_formatter& this_thread_formatter() noexcept {
+            thread_local auto formatter = thread_formatter();
+            return formatter;
+        }
+
+        using clock = std::chrono::system_clock;
+
+        // One queued insertion, or part of one that did not fit in a single record
+        struct log_record {
+            static auto constexpr text_capacity = std::size_t(240);
+            static_assert(text_capacity <= UINT8_MAX, "length must be able to hold text_capacity");
+
+            // Position in the queue this slot is next free for, plus one once it is written
+            std::atomic<std::size_t> sequence;
+
+            clock::time_point time;
+            log_detail::category_state const* category;
+            log_type type;
+            bool isFirst;
+            std::uint8_t length;
+            std::array<char, text_capacity> text;
+        };
+
+        // Producers claim runs of slots in a bounded lock-free queue (as in Vyukov's bounded
+        // MPMC queue) and never wait. Whoever holds m_outputMutex is the single consumer:
+        // normally the background thread, or a thread calling flush.
+        class log_backend {
+        public:
+            static auto constexpr queue_capacity = std::size_t(2048);
+
+            log_backend() noexcept : m_records(std::make_unique<std::array<log_record, queue_capacity>>()) {
+                for (std::size_t i = 0; i < queue_capacity; ++i) (*m_records)[i].sequence.store(i, std::memory_order_relaxed);
+
+                try {
+                    m_thread = std::thread([this] { run(); });
+                } catch (...) {
+                    // Without a thread, every insertion is written as it is made
+                    m_synchronous.store(true, std::memory_order_release);
+                }
+            }
+
+            // Returns false if the queue was full
+            [[nodiscard]] bool push(log_type _type, log_detail::category_state const* _category, bool _isFirst, std::string_view _text) noexcept {
+                auto const count = std::max(std::size_t(1), (_text.size() + log_record::text_capacity - 1) / log_record::text_capacity);
+
+                auto position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+                while (true) {
+                    // The consumer frees slots in order, so if the last slot of the run is
+                    // free, all of them are
+                    auto const lastPosition = position + count - 1;
+                    auto const sequence = record_at(lastPosition).sequence.load(std::memory_order_acquire);
+                    auto const difference = std::intptr_t(sequence) - std::intptr_t(lastPosition);
+
+                    if (difference == 0) {
+                        if (m_enqueuePosition.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) break;
+                    } else if (difference < 0) {
+                        return false;
+                    } else {
+                        position = m_enqueuePosition.load(std::memory_order_relaxed);
+                    }
+                }
+
+                auto const time = _isFirst ? clock::now() : clock::time_point();
+
+                for (std::size_t i = 0; i < count; ++i) {
+                    auto const part = _text.substr(i * log_record::text_capacity, log_record::text_capacity);
+
+                    auto& record = record_at(position + i);
+                    record.time = time;
+                    record.category = _category;
+                    record.type = _type;
+                    record.isFirst = _isFirst && i == 0;
+                    record.length = std::uint8_t(part.size());
+                    std::copy(begin(part), end(part), begin(record.text));
+
+                    record.sequence.store(position + i + 1, std::memory_order_release);
+                }
+
+                if (m_synchronous.load(std::memory_order_acquire)) {
+                    flush();
+                } else if (!m_pending.exchange(true, std::memory_order_acq_rel)) {
+                    m_wakeup.notify_one();
+                }
+
+                return true;
+            }
+
+            void count_dropped_message() noexcept { m_dropped.fetch_add(1, std::memory_order_relaxed); }
+
+            void flush() noexcept {
+                auto lock = std::lock_guard(m_outputMutex);
+                drain();
+            }
+
+            void set_output(std::ostream& _stream) noexcept {
+                auto lock = std::lock_guard(m_outputMutex);
+                drain();
+                m_output = &_stream;
+            }
+
+            [[nodiscard]] std::ostream& output() noexcept {
+                auto lock = std::lock_guard(m_outputMutex);
+                drain();
+                return *m_output;
+            }
+
+            // Stops the thread once it has written everything; anything logged after this
+            // is written synchronously
+            void shutdown() noexcept {
+                if (!m_thread.joinable()) return;
+
+                {
+                    auto lock = std::lock_guard(m_wakeupMutex);
+                    m_stopping = true;
+                }
+
+                m_wakeup.notify_one();
+                m_thread.join();
+
+                m_synchronous.store(true, std::memory_order_release);
+                flush();
+            }
+
+        private:
+            // Only a backstop for a missed notification
+            static auto constexpr max_idle_wait = std::chrono::milliseconds(100);
+
+            [[nodiscard]] log_record& record_at(std::size_t _position) noexcept { return (*m_records)[_position % queue_capacity]; }
+
+            void run() noexcept {
+                while (true) {
+                    bool stopping;
+
+                    {
+                        auto lock = std::unique_lock(m_wakeupMutex);
+                        m_wakeup.wait_for(lock, max_idle_wait, [&] { return m_stopping || m_pending.load(std::memory_order_acquire); });
+                        stopping = m_stopping;
+                    }
+
+                    // Cleared before draining, so that anything pushed meanwhile wakes us again
+                    m_pending.store(false, std::memory_order_release);
+                    flush();
+
+                    if (stopping) return;
+                }
+            }
+
+            // Requires m_outputMutex
+            void drain() noexcept {
+                auto& stream = *m_output;
+                auto wroteAny = false;
+
+                try {
+                    while (true) {
+                        auto& record = record_at(m_dequeuePosition);
+                        if (record.sequence.load(std::memory_order_acquire) != m_dequeuePosition + 1) break;
+
+                        write_record(stream, record);
+                        wroteAny = true;
+
+                        record.sequence.store(m_dequeuePosition + queue_capacity, std::memory_order_release);
+                        ++m_dequeuePosition;
+                    }
+
+                    if (auto const dropped = m_dropped.exchange(0, std::memory_order_relaxed); dropped != 0) {
+                        write_header(stream, log_type::WARN, nullptr, clock::now());
+                        stream << dropped << " log messages dropped because the log queue was full";
+                        wroteAny = true;
+                    }
+
+                    if (wroteAny) stream.flush();
+                } catch (...) {
+                    // Drop error, logging is not vital
+                }
+            }
+
+            void write_record(std::ostream& _stream, log_record const& _record) noexcept(!"Throws on stream error") {
+                if (_record.isFirst) write_header(_stream, _record.type, _record.category, _record.time);
+
+                auto text = std::string_view(_record.text.data(), _record.length);
+
+                for (auto newline = text.find('\n'); newline != std::string_view::npos; newline = text.find('\n')) {
+                    _stream.write(text.data(), std::streamsize(newline));
+                    _stream.write(continuation_header.data(), std::streamsize(continuation_header.size()));
+                    text.remove_prefix(newline + 1);
+                }
+
+                _stream.write(text.data(), std::streamsize(text.size()));
+            }
+
+            void write_header(std::ostream& _stream, log_type _type, log_detail::category_state const* _category, clock::time_point _time) noexcept(
+                !"Throws on stream error") {
+                auto const systemTime = clock::to_time_t(_time);
+
+                // Most records share their second with the one before
+                if (systemTime != m_formattedTime) {
+                    std::tm formatTime;
+                    localtime_r(&systemTime, &formatTime);
+
+                    m_formattedTimeLength = std::strftime(m_formattedTimeText.data(), m_formattedTimeText.size(), "%Y-%m-%d %H:%M:%S", &formatTime);
+                    m_formattedTime = systemTime;
+                }
+
+                _stream << "\n[";
+                _stream.write(m_formattedTimeText.data(), std::streamsize(m_formattedTimeLength));
+                _stream << "] " << log_detail::log_type_header(_type) << " ";
+                if (_category) _stream << "[" << _category->name << "] ";
+            }
+
+            std::unique_ptr<std::array<log_record, queue_capacity>> m_records;
+            std::atomic<std::size_t> m_enqueuePosition{0};
+            std::atomic<std::int64_t> m_dropped{0};
+
+            // Guarded by m_outputMutex
+            std::mutex m_outputMutex;
+            std::ostream* m_output = &std::clog;
+            std::size_t m_dequeuePosition = 0;
+            std::time_t m_formattedTime = -1;
+            std::array<char, 32> m_formattedTimeText{};
+            std::size_t m_formattedTimeLength = 0;
+
+            std::mutex m_wakeupMutex;
+            std::condition_variable m_wakeup;
+            std::atomic<bool> m_pending{false};
+            bool m_stopping = false;
+
+            std::atomic<bool> m_synchronous{false};
+            std::thread m_thread;
+        };
+
+        // Never destroyed, so that logging still works during static destruction. The thread
+        // is stopped at exit, after writing everything logged before then.
+        log_backend& backend() noexcept {
+            static auto* const instance = [] {
+                auto* const result = new log_backend();
+                std::atexit([] { backend().shutdown(); });
+                return result;
+            }();
+
+            return *instance;
+        }
+
+        struct category_registry {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<log_detail::category_state>> categories;
+        };
+
+        // Never destroyed, like the states in it
+        category_registry& categories() noexcept {
+            static auto* const instance = new category_registry();
+            return *instance;
+        }
+    }    // namespace
+
+    namespace log_detail {
+        category_state& find_category(std::string_view _name) noexcept(false) {
+            auto& registry = categories();
+            auto lock = std::lock_guard(registry.mutex);
+
+            // There are only ever a handful of categories
+            for (auto const& category : registry.categories) {
+                if (category->name == _name) return *category;
+            }
+
+            registry.categories.push_back(std::make_unique<category_state>());
+            registry.categories.back()->name = std::string(_name);
+
+            return *registry.categories.back();
+        }
+
+        std::ostream& begin_record() noexcept {
+            auto& formatter = this_thread_formatter();
+
+            formatter.buffer.reset();
+            formatter.stream.clear();
+            formatter.stream.flags(formatter.defaultFlags);
+            formatter.stream.precision(formatter.defaultPrecision);
+            formatter.stream.width(0);
+            formatter.stream.fill(' ');
+
+            return formatter.stream;
+        }
+
+        void submit_record(log_type _logType, category_state const* _category, bool _isFirst) noexcept {
+            submit_record(_logType, _category, _isFirst, this_thread_formatter().buffer.text());
+        }
+
+        void submit_record(log_type _logType, category_state const* _category, bool _isFirst, std::string_view _text) noexcept {
+            // Once part of a message is dropped, so is the rest of it, rather than being
+            // appended to some other message
+            thread_local auto droppingMessage = false;
+
+            if (_isFirst) {
+                droppingMessage = false;
+            } else if (droppingMessage) {
+                return;
+            }
+
+            if (!backend().push(_logType, _category, _isFirst, _text)) {
+                droppingMessage = true;
+                backend().count_dropped_message();
+            }
+        }
+    }    // namespace log_detail
+
+    void set_category_min_level(std::string_view _name, log_type _level) noexcept(false) {
+        log_detail::find_category(_name).minLevel.store(std::uint8_t(_level), std::memory_order_relaxed);
+    }
+
+    void silence_category(std::string_view _name) noexcept(false) {
+        log_detail::find_category(_name).minLevel.store(log_detail::silent_level, std::memory_order_relaxed);
+    }
+
+    void reset_category_level(std::string_view _name) noexcept(false) {
+        log_detail::find_category(_name).minLevel.store(log_detail::inherit_level, std::memory_order_relaxed);
+    }
+
+    void flush() noexcept { backend().flush(); }
+
+    void set_log_output(std::ostream& _stream) noexcept { backend().set_output(_stream); }
+
+    std::ostream& raw_log() noexcept { return backend().output(); }
+}    // namespace randomcat::engine::log
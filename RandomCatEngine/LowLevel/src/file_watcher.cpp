@@ -0,0 +1,104 @@
+#include "randomcat/engine/low_level/file_watcher.hpp"
+
+#if RC_ENGINE_HOT_RELOAD
+#    include <algorithm>
+#    include <array>
+#    include <cerrno>
+#    include <cstdint>
+#    include <cstring>
+
+#    include <poll.h>
+#    include <sys/eventfd.h>
+#    include <sys/inotify.h>
+#    include <unistd.h>
+
+namespace randomcat::engine {
+    namespace {
+        // IN_MOVED_TO covers saves that rename a temporary file over the original
+        auto constexpr watched_events = IN_CLOSE_WRITE | IN_MOVED_TO;
+
+        [[nodiscard]] std::string errno_message() { return std::strerror(errno); }
+    }    // namespace
+
+    file_watcher::file_watcher() noexcept(false) : m_inotify(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)), m_interrupt(-1) {
+        if (m_inotify < 0) throw file_watcher_error{"Unable to initialize inotify: " + errno_message()};
+
+        m_interrupt = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (m_interrupt < 0) {
+            close(m_inotify);
+            throw file_watcher_error{"Unable to create eventfd: " + errno_message()};
+        }
+    }
+
+    file_watcher::~file_watcher() noexcept {
+        close(m_interrupt);
+        close(m_inotify);
+    }
+
+    fs::path file_watcher::watch(fs::path const& _path) noexcept(false) {
+        auto const path = absolute(_path).lexically_normal();
+        auto const directory = path.parent_path();
+
+        auto const descriptor = inotify_add_watch(m_inotify, directory.c_str(), watched_events);
+        if (descriptor < 0) throw file_watcher_error{"Unable to watch " + directory.string() + ": " + errno_message()};
+
+        auto const lock = std::lock_guard(m_mutex);
+
+        // inotify returns the existing descriptor if the directory is already watched
+        m_directories.emplace(descriptor, directory);
+        m_files[directory.string()].insert(path.filename().string());
+
+        return path;
+    }
+
+    std::vector<fs::path> file_watcher::wait_for_changes(std::chrono::milliseconds _timeout) noexcept(false) {
+        auto descriptors = std::array<pollfd, 2>{pollfd{m_inotify, POLLIN, 0}, pollfd{m_interrupt, POLLIN, 0}};
+
+        if (poll(descriptors.data(), descriptors.size(), int(_timeout.count())) < 0 && errno != EINTR) {
+            throw file_watcher_error{"Unable to poll inotify: " + errno_message()};
+        }
+
+        if (descriptors[1].revents & POLLIN) {
+            std::uint64_t count;
+            (void)read(m_interrupt, &count, sizeof(count));
+        }
+
+        std::vector<fs::path> changed;
+
+        // Aligned as inotify_event requires
+        alignas(inotify_event) std::array<char, 4096> buffer;
+
+        while (true) {
+            auto const length = read(m_inotify, buffer.data(), buffer.size());
+            if (length <= 0) break;
+
+            auto const lock = std::lock_guard(m_mutex);
+
+            for (auto position = buffer.data(); position < buffer.data() + length;) {
+                auto const& event = *reinterpret_cast<inotify_event const*>(position);
+                position += sizeof(inotify_event) + event.len;
+
+                if (event.len == 0) continue;
+
+                auto const directory = m_directories.find(event.wd);
+                if (directory == end(m_directories)) continue;
+
+                auto const& files = m_files[directory->second.string()];
+                if (files.find(event.name) == end(files)) continue;
+
+                auto path = directory->second / event.name;
+                if (std::find(begin(changed), end(changed), path) == end(changed)) changed.push_back(std::move(path));
+            }
+        }
+
+        return changed;
+    }
+
+    void file_watcher::interrupt() noexcept {
+        auto const count = std::uint64_t(1);
+        (void)write(m_interrupt, &count, sizeof(count));
+    }
+}    // namespace randomcat::engine
+
+#endif
@@ -3,8 +3,13 @@
 #include <GL/glew.h>
 #include <gsl/gsl_util>
 
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
+
 namespace randomcat::engine::graphics::gl_detail {
-    void activate_vao(raw_vao_id _vao) noexcept { glBindVertexArray(_vao.value); }
+    void activate_vao(raw_vao_id _vao) noexcept {
+        glBindVertexArray(_vao.value);
+        render_stats_detail::count_state_bind();
+    }
 
     raw_vao_id current_vao() noexcept {
         GLint ret;
@@ -12,7 +17,10 @@ namespace randomcat::engine::graphics::gl_detail {
         return raw_vao_id{gsl::narrow<opengl_raw_id>(ret)};
     }
 
-    void activate_vbo(raw_vbo_id _vbo) noexcept { glBindBuffer(GL_ARRAY_BUFFER, _vbo.value); }
+    void activate_vbo(raw_vbo_id _vbo) noexcept {
+        glBindBuffer(GL_ARRAY_BUFFER, _vbo.value);
+        render_stats_detail::count_state_bind();
+    }
 
     raw_vbo_id current_vbo() noexcept {
         GLint ret;
@@ -20,7 +28,10 @@ namespace randomcat::engine::graphics::gl_detail {
         return raw_vbo_id{gsl::narrow<opengl_raw_id>(ret)};
     }
 
-    void activate_program(raw_program_id _program) noexcept { glUseProgram(_program.value); }
+    void activate_program(raw_program_id _program) noexcept {
+        glUseProgram(_program.value);
+        render_stats_detail::count_state_bind();
+    }
 
     raw_program_id current_program() noexcept {
         GLint ret;
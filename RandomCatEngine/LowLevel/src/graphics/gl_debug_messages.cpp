@@ -0,0 +1,189 @@
+#include "randomcat/engine/low_level/graphics/gl_debug_messages.hpp"
+
+#include <algorithm>
+#include <ostream>
+
+#include "randomcat/engine/low_level/detail/log.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
+
+namespace randomcat::engine::graphics {
+    namespace {
+        // Filter with log::set_category_min_level("gl", ...)
+        auto const gl_log = log::log_category("gl");
+
+        std::string_view gl_debug_type_name(GLenum _type) noexcept {
+            using namespace std::string_view_literals;
+
+            switch (_type) {
+                case GL_DEBUG_TYPE_ERROR: return "ERROR"sv;
+                case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "DEPRECATED BEHAVIOR"sv;
+                case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "UNDEFINED BEHAVIOR"sv;
+                case GL_DEBUG_TYPE_PORTABILITY: return "PORTABILITY ERROR"sv;
+                case GL_DEBUG_TYPE_PERFORMANCE: return "PERFORMANCE ISSUE"sv;
+                case GL_DEBUG_TYPE_MARKER: return "MARKER"sv;
+                case GL_DEBUG_TYPE_PUSH_GROUP: return "DEBUG INFO GROUP PUSH"sv;
+                case GL_DEBUG_TYPE_POP_GROUP: return "DEBUG INFO GROUP POP"sv;
+                case GL_DEBUG_TYPE_OTHER: return "OTHER INFO"sv;
+                default: return "UNRECOGNIZED GROUP"sv;
+            }
+        }
+
+        std::string_view gl_debug_serverity_name(GLenum _severity) noexcept {
+            using namespace std::string_view_literals;
+
+            switch (_severity) {
+                case GL_DEBUG_SEVERITY_HIGH: return "HIGH"sv;
+                case GL_DEBUG_SEVERITY_MEDIUM: return "MEDIUM"sv;
+                case GL_DEBUG_SEVERITY_LOW: return "LOW"sv;
+                case GL_DEBUG_SEVERITY_NOTIFICATION: return "NOTIFICATION"sv;
+                default: return "UNRECOGNIZED SEVERITY"sv;
+            }
+        }
+
+        std::string_view gl_debug_source_name(GLenum _source) noexcept {
+            using namespace std::string_view_literals;
+
+            switch (_source) {
+                case GL_DEBUG_SOURCE_API: return "API"sv;
+                case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "WINDOW SYSTEM"sv;
+                case GL_DEBUG_SOURCE_SHADER_COMPILER: return "SHADER COMPILER"sv;
+                case GL_DEBUG_SOURCE_THIRD_PARTY: return "THIRD PARTY"sv;
+                case GL_DEBUG_SOURCE_APPLICATION: return "APPLICATION"sv;
+                case GL_DEBUG_SOURCE_OTHER: return "OTHER"sv;
+                default: return "UNRECOGNIZED SOURCE"sv;
+            }
+        }
+
+        struct message_header {
+            GLenum source;
+            GLenum type;
+            GLenum severity;
+            GLuint id;
+        };
+
+        std::ostream& operator<<(std::ostream& _stream, message_header const& _header) noexcept(false) {
+            return _stream << "[FROM " << gl_debug_source_name(_header.source) << "] [OF TYPE " << gl_debug_type_name(_header.type)
+                           << "] [WITH SEVERITY " << gl_debug_serverity_name(_header.severity) << "] [ID " << _header.id << "]";
+        }
+
+        [[nodiscard]] log::log_type log_type_for(GLenum _severity) noexcept {
+            switch (_severity) {
+                case GL_DEBUG_SEVERITY_HIGH: return log::log_type::ERROR;
+                case GL_DEBUG_SEVERITY_MEDIUM:
+                case GL_DEBUG_SEVERITY_LOW: return log::log_type::WARN;
+                default: return log::log_type::INFO;
+            }
+        }
+
+        // Sources and types are small enums, so this is never zero
+        [[nodiscard]] std::uint64_t message_key(GLenum _source, GLenum _type, GLuint _id) noexcept {
+            return (std::uint64_t(_id) << 32) | (std::uint64_t(_source & 0xFFFF) << 16) | std::uint64_t(_type & 0xFFFF);
+        }
+    }    // namespace
+
+    gl_debug_messages::gl_debug_messages() noexcept(false)
+    : m_slots(std::make_unique<std::array<message_slot, capacity>>()), m_reportStates(capacity) {}
+
+    void gl_debug_messages::record(GLenum _source, GLenum _type, GLuint _id, GLenum _severity, std::string_view _message) noexcept {
+        auto const key = message_key(_source, _type, _id);
+
+        // Fibonacci hashing, then linear probing
+        auto const start = std::size_t((key * 0x9E3779B97F4A7C15ull) >> 56) % capacity;
+
+        for (std::size_t probe = 0; probe < capacity; ++probe) {
+            auto& slot = (*m_slots)[(start + probe) % capacity];
+
+            auto existing = slot.key.load(std::memory_order_acquire);
+
+            if (existing == 0 && slot.key.compare_exchange_strong(existing, key, std::memory_order_acq_rel)) {
+                slot.source = _source;
+                slot.type = _type;
+                slot.id = _id;
+                slot.severity = _severity;
+                slot.length = std::min(_message.size(), max_message_length);
+                std::copy_n(_message.data(), slot.length, slot.text.data());
+
+                slot.ready.store(true, std::memory_order_release);
+                existing = key;
+            }
+
+            if (existing == key) {
+                slot.pending.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+
+        m_overflow.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool gl_debug_messages::take_report(GLenum _source, GLenum _type, clock::time_point _now) noexcept(false) {
+        // There are only ever a handful of sources and types
+        auto limit = std::find_if(begin(m_rateLimits), end(m_rateLimits), [&](rate_limit const& _limit) {
+            return _limit.source == _source && _limit.type == _type;
+        });
+
+        if (limit == end(m_rateLimits)) {
+            m_rateLimits.push_back(rate_limit{_source, _type, _now, 0});
+            limit = end(m_rateLimits) - 1;
+        }
+
+        if (_now - limit->windowStart >= std::chrono::seconds(1)) {
+            limit->windowStart = _now;
+            limit->reports = 0;
+        }
+
+        if (limit->reports == reports_per_second) return false;
+
+        ++limit->reports;
+        return true;
+    }
+
+    void gl_debug_messages::report() noexcept {
+        try {
+            auto const now = clock::now();
+            auto frameMessages = std::int64_t(0);
+
+            for (std::size_t index = 0; index < capacity; ++index) {
+                auto& slot = (*m_slots)[index];
+                if (!slot.ready.load(std::memory_order_acquire)) continue;
+
+                auto const count = slot.pending.exchange(0, std::memory_order_relaxed);
+                frameMessages += count;
+
+                // Includes messages held back by the rate limit in earlier frames
+                auto& state = m_reportStates[index];
+                state.unreported += count;
+                if (state.unreported == 0) continue;
+
+                auto const level = log_type_for(slot.severity);
+                auto const due = !state.announced || now - state.lastReport >= std::chrono::seconds(1);
+
+                if (!due || !gl_log.is_enabled(level) || !take_report(slot.source, slot.type, now)) continue;
+
+                auto const header = message_header{slot.source, slot.type, slot.severity, slot.id};
+                auto const text = std::string_view(slot.text.data(), slot.length);
+
+                if (state.announced) {
+                    log::log(level, gl_log) << header << " repeated " << state.unreported << " times";
+                } else if (state.unreported > 1) {
+                    log::log(level, gl_log) << header << ": " << text << " (" << state.unreported << " times)";
+                } else {
+                    log::log(level, gl_log) << header << ": " << text;
+                }
+
+                state.announced = true;
+                state.unreported = 0;
+                state.lastReport = now;
+            }
+
+            if (auto const overflow = m_overflow.exchange(0, std::memory_order_relaxed); overflow != 0) {
+                frameMessages += overflow;
+                RC_LOG_CATEGORY(gl_log, WARN) << overflow << " GL debug messages were not reported; more than " << capacity << " distinct messages were seen";
+            }
+
+            render_stats_detail::count_debug_messages(frameMessages);
+        } catch (...) {
+            // Drop error, logging is not vital
+        }
+    }
+}    // namespace randomcat::engine::graphics
@@ -0,0 +1,139 @@
+#include "randomcat/engine/low_level/graphics/gpu_profiler.hpp"
+
+#include <algorithm>
+
+namespace randomcat::engine::graphics {
+    namespace {
+        [[nodiscard]] double as_milliseconds(std::chrono::nanoseconds _time) noexcept {
+            return std::chrono::duration<double, std::milli>(_time).count();
+        }
+
+        [[nodiscard]] std::chrono::nanoseconds average(std::chrono::nanoseconds _total, std::int64_t _calls) noexcept {
+            return _calls == 0 ? std::chrono::nanoseconds(0) : _total / _calls;
+        }
+    }    // namespace
+
+    std::ostream& operator<<(std::ostream& _stream, gpu_scope_timing const& _timing) noexcept(false) {
+        return _stream << _timing.name << ": " << _timing.calls << " calls, ms: gpu mean " << as_milliseconds(average(_timing.gpuTotal, _timing.calls))
+                       << ", gpu max " << as_milliseconds(_timing.gpuMax) << ", cpu mean "
+                       << as_milliseconds(average(_timing.cpuTotal, _timing.calls)) << ", cpu max " << as_milliseconds(_timing.cpuMax);
+    }
+
+    gpu_profiler::gpu_profiler() noexcept(false)
+    : m_hasTimerQueries(GLEW_ARB_timer_query), m_queries(frames_in_flight * max_scopes_per_frame * 2), m_slots(frames_in_flight) {
+        if (m_hasTimerQueries) glGenQueries(GLsizei(m_queries.size()), m_queries.data());
+
+        for (auto& slot : m_slots) slot.scopes.reserve(max_scopes_per_frame);
+    }
+
+    gpu_profiler::~gpu_profiler() noexcept {
+        if (m_hasTimerQueries) glDeleteQueries(GLsizei(m_queries.size()), m_queries.data());
+    }
+
+    void gpu_profiler::begin_frame() noexcept {
+        ++m_frame;
+
+        auto& slot = current_slot();
+        collect(slot);
+
+        slot.frame = m_frame;
+        slot.scopes.clear();
+        slot.lastQuery = 0;
+    }
+
+    void gpu_profiler::reset() noexcept {
+        for (auto& timing : m_timings) timing = gpu_scope_timing{std::move(timing.name), 0, time(0), time(0), time(0), time(0)};
+
+        m_droppedScopes = 0;
+        m_droppedFrames = 0;
+    }
+
+    gpu_profiler_detail::scope_handle gpu_profiler::begin_scope(std::string_view _name) noexcept {
+        auto& slot = current_slot();
+
+        if (slot.scopes.size() == max_scopes_per_frame) {
+            ++m_droppedScopes;
+            return gpu_profiler_detail::scope_handle{m_frame, no_scope};
+        }
+
+        auto const index = slot.scopes.size();
+        slot.scopes.push_back(pending_scope{timing_index(_name), clock::now(), {}, false});
+
+        if (m_hasTimerQueries) {
+            slot.lastQuery = query(m_frame, index, false);
+            glQueryCounter(slot.lastQuery, GL_TIMESTAMP);
+        }
+
+        return gpu_profiler_detail::scope_handle{m_frame, index};
+    }
+
+    void gpu_profiler::end_scope(gpu_profiler_detail::scope_handle _handle) noexcept {
+        if (_handle.index == no_scope) return;
+
+        // The scope outlived its frame's slot, which has since been reused
+        auto& slot = m_slots[_handle.frame % frames_in_flight];
+        if (slot.frame != _handle.frame) return;
+
+        auto& scope = slot.scopes[_handle.index];
+        scope.cpuEnd = clock::now();
+        scope.ended = true;
+
+        if (m_hasTimerQueries) {
+            slot.lastQuery = query(_handle.frame, _handle.index, true);
+            glQueryCounter(slot.lastQuery, GL_TIMESTAMP);
+        }
+    }
+
+    GLuint gpu_profiler::query(std::uint64_t _frame, std::size_t _scope, bool _end) const noexcept {
+        return m_queries[((_frame % frames_in_flight) * max_scopes_per_frame + _scope) * 2 + (_end ? 1 : 0)];
+    }
+
+    std::size_t gpu_profiler::timing_index(std::string_view _name) noexcept {
+        // There are only ever a handful of distinct scopes
+        auto const existing =
+            std::find_if(begin(m_timings), end(m_timings), [&](gpu_scope_timing const& _timing) { return _timing.name == _name; });
+        if (existing != end(m_timings)) return std::size_t(existing - begin(m_timings));
+
+        m_timings.push_back(gpu_scope_timing{std::string(_name), 0, time(0), time(0), time(0), time(0)});
+        return m_timings.size() - 1;
+    }
+
+    void gpu_profiler::collect(frame_slot& _slot) noexcept {
+        if (_slot.scopes.empty()) return;
+
+        if (m_hasTimerQueries && _slot.lastQuery != 0) {
+            GLint available = GL_FALSE;
+            glGetQueryObjectiv(_slot.lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+
+            if (!available) {
+                ++m_droppedFrames;
+                return;
+            }
+        }
+
+        for (std::size_t index = 0; index < _slot.scopes.size(); ++index) {
+            auto const& scope = _slot.scopes[index];
+            if (!scope.ended) continue;
+
+            auto gpuTime = time(0);
+
+            if (m_hasTimerQueries) {
+                GLuint64 begin = 0;
+                GLuint64 end = 0;
+                glGetQueryObjectui64v(query(_slot.frame, index, false), GL_QUERY_RESULT, &begin);
+                glGetQueryObjectui64v(query(_slot.frame, index, true), GL_QUERY_RESULT, &end);
+
+                gpuTime = time(std::int64_t(end - begin));
+            }
+
+            auto const cpuTime = std::chrono::duration_cast<time>(scope.cpuEnd - scope.cpuBegin);
+
+            auto& timing = m_timings[scope.timing];
+            ++timing.calls;
+            timing.gpuTotal += gpuTime;
+            timing.gpuMax = std::max(timing.gpuMax, gpuTime);
+            timing.cpuTotal += cpuTime;
+            timing.cpuMax = std::max(timing.cpuMax, cpuTime);
+        }
+    }
+}    // namespace randomcat::engine::graphics
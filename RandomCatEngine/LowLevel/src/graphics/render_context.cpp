@@ -1,61 +1,198 @@
 #include "randomcat/engine/low_level/graphics/render_context.hpp"
 
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <utility>
+#include <vector>
+
 #include <GL/glew.h>
+#include <gsl/gsl_util>
+
+#if RC_ENGINE_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
 
 namespace randomcat::engine::graphics {
     namespace {
-        std::string_view gl_debug_type_name(GLenum _type) noexcept {
-            using namespace std::string_view_literals;
-
-            switch (_type) {
-                case GL_DEBUG_TYPE_ERROR: return "ERROR"sv;
-                case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR: return "DEPRECATED BEHAVIOR"sv;
-                case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR: return "UNDEFINED BEHAVIOR"sv;
-                case GL_DEBUG_TYPE_PORTABILITY: return "PORTABILITY ERROR"sv;
-                case GL_DEBUG_TYPE_PERFORMANCE: return "PERFORMANCE ISSUE"sv;
-                case GL_DEBUG_TYPE_MARKER: return "MARKER"sv;
-                case GL_DEBUG_TYPE_PUSH_GROUP: return "DEBUG INFO GROUP PUSH"sv;
-                case GL_DEBUG_TYPE_POP_GROUP: return "DEBUG INFO GROUP POP"sv;
-                case GL_DEBUG_TYPE_OTHER: return "OTHER INFO"sv;
-                default: return "UNRECOGNIZED GROUP"sv;
-            }
+        GLAPIENTRY void gl_log_callback(GLenum _source, GLenum _type, GLuint _id, GLenum _severity, GLsizei _length, const GLchar* _message, const void* _userParam) {
+            // May be called on any thread, and many times a frame, so this only records the message
+            static_cast<gl_debug_messages*>(const_cast<void*>(_userParam))->record(_source, _type, _id, _severity, std::string_view(_message, _length));
+        }
+
+        void enable_debug_output(gl_debug_messages& _messages) noexcept {
+            log::info << "Context created with debugging";
+
+            glEnable(GL_DEBUG_OUTPUT);
+            glDebugMessageCallback(gl_log_callback, &_messages);
+
+            // Notifications are mostly driver chatter (buffer placement and the like)
+            glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+        }
+
+#if RC_ENGINE_HEADLESS
+        [[noreturn]] void throw_egl_error(std::string_view _what) noexcept(false) {
+            auto message = std::ostringstream();
+            message << "Error " << _what << ": EGL error 0x" << std::hex << eglGetError();
+
+            throw render_context_init_error{message.str()};
         }
 
-        std::string_view gl_debug_serverity_name(GLenum _severity) noexcept {
-            using namespace std::string_view_literals;
+        [[nodiscard]] bool has_extension(char const* _extensions, std::string_view _name) noexcept {
+            if (!_extensions) return false;
+
+            auto extensions = std::istringstream(_extensions);
+            std::string extension;
+
+            while (extensions >> extension) {
+                if (extension == _name) return true;
+            }
+
+            return false;
+        }
 
-            switch (_severity) {
-                case GL_DEBUG_SEVERITY_HIGH: return "HIGH"sv;
-                case GL_DEBUG_SEVERITY_MEDIUM: return "MEDIUM"sv;
-                case GL_DEBUG_SEVERITY_LOW: return "LOW"sv;
-                case GL_DEBUG_SEVERITY_NOTIFICATION: return "NOTIFICATION"sv;
-                default: return "UNRECOGNIZED SEVERITY"sv;
+        [[nodiscard]] EGLDisplay open_headless_display() noexcept {
+            // Surfaceless needs neither a display server nor a GPU device
+            if (has_extension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless")) {
+                auto const getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+                if (getPlatformDisplay) return getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
             }
+
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        // The contexts of headless render_contexts. SDL uses EGL itself on Wayland and
+        // KMSDRM, so a current EGL context is only headless if it is one of these.
+        struct headless_context_registry {
+            std::mutex mutex;
+            std::vector<std::pair<EGLDisplay, EGLContext>> contexts;
+        };
+
+        [[nodiscard]] headless_context_registry& headless_contexts() noexcept {
+            static auto registry = headless_context_registry();
+            return registry;
+        }
+
+        [[nodiscard]] bool is_headless_context(EGLContext _context) noexcept {
+            auto& registry = headless_contexts();
+            auto const lock = std::lock_guard(registry.mutex);
+
+            return std::any_of(begin(registry.contexts), end(registry.contexts), [&](auto const& _entry) { return _entry.second == _context; });
+        }
+
+        // eglTerminate is not reference counted, so the display is only terminated once no
+        // headless context uses it
+        void release_headless_display(EGLDisplay _display) noexcept {
+            auto& registry = headless_contexts();
+            auto const lock = std::lock_guard(registry.mutex);
+
+            auto const inUse = std::any_of(begin(registry.contexts), end(registry.contexts), [&](auto const& _entry) { return _entry.first == _display; });
+            if (!inUse) eglTerminate(_display);
         }
 
-        std::string_view gl_debug_source_name(GLenum _source) noexcept {
-            using namespace std::string_view_literals;
+        void destroy_headless_context(render_context_detail::context_data const& _context) noexcept {
+            {
+                auto& registry = headless_contexts();
+                auto const lock = std::lock_guard(registry.mutex);
 
-            switch (_source) {
-                case GL_DEBUG_SOURCE_API: return "API"sv;
-                case GL_DEBUG_SOURCE_WINDOW_SYSTEM: return "WINDOWING SYSTEM"sv;
-                case GL_DEBUG_SOURCE_SHADER_COMPILER: return "SHADER COMPILER"sv;
-                case GL_DEBUG_SOURCE_THIRD_PARTY: return "THIRD PARTY"sv;
-                case GL_DEBUG_SOURCE_APPLICATION: return "APPLICATION"sv;
-                case GL_DEBUG_SOURCE_OTHER: return "OTHER"sv;
-                default: return "UNRECOGNIZED SOURCE"sv;
+                auto const entry = std::find(begin(registry.contexts), end(registry.contexts), std::pair(_context.eglDisplay, _context.eglContext));
+                if (entry != end(registry.contexts)) registry.contexts.erase(entry);
             }
+
+            eglDestroyContext(_context.eglDisplay, _context.eglContext);
+            release_headless_display(_context.eglDisplay);
         }
 
-        GLAPIENTRY void gl_log_callback(GLenum _source, GLenum _type, GLuint _id, GLenum _severity, GLsizei _length, const GLchar* _message, const void* _userParam) {
-            log::warn << "[GL DEBUG LOG INFO] "
-                      << "[FROM " << gl_debug_source_name(_source) << "] [OF TYPE " << gl_debug_type_name(_type) << "] [WITH SEVERITY "
-                      << gl_debug_serverity_name(_severity) << "]: " << std::string_view(_message, _length);
+        [[nodiscard]] render_context_detail::context_data make_headless_context(render_context::flags _flags) noexcept(false) {
+            auto const display = open_headless_display();
+            if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) throw_egl_error("initializing EGL display");
+
+            // throw_egl_error reads the EGL error before this runs, so terminating does not lose it
+            auto created = false;
+            auto const releaseDisplay = gsl::finally([&] {
+                if (!created) release_headless_display(display);
+            });
+
+            if (!has_extension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+                throw render_context_init_error{"EGL display does not support surfaceless contexts"};
+            }
+
+            if (!eglBindAPI(EGL_OPENGL_API)) throw_egl_error("binding OpenGL API");
+
+            // Everything is drawn into a framebuffer object, so the config only matters if one is required
+            auto config = EGLConfig(nullptr);
+            if (!has_extension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_no_config_context")) {
+                EGLint const configAttributes[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+                EGLint configCount = 0;
+
+                if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0) {
+                    throw_egl_error("choosing EGL config");
+                }
+            }
+
+            // The engine's shaders are GLSL 3.30 core, so ask for at least that rather than
+            // whatever the driver would give by default
+            EGLint const contextAttributes[] = {EGL_CONTEXT_MAJOR_VERSION,
+                                                3,
+                                                EGL_CONTEXT_MINOR_VERSION,
+                                                3,
+                                                EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                                EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                                EGL_CONTEXT_OPENGL_DEBUG,
+                                                is_debug(_flags) ? EGL_TRUE : EGL_FALSE,
+                                                EGL_NONE};
+
+            auto const context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+            if (context == EGL_NO_CONTEXT) throw_egl_error("creating EGL context");
+
+            try {
+                auto& registry = headless_contexts();
+                auto const lock = std::lock_guard(registry.mutex);
+
+                registry.contexts.emplace_back(display, context);
+            } catch (...) {
+                eglDestroyContext(display, context);
+                throw;
+            }
+
+            created = true;
+            return render_context_detail::context_data{nullptr, nullptr, display, context};
         }
+#endif
     }    // namespace
 
+    namespace render_context_detail {
+        void activate_context(context_data _context) noexcept {
+#if RC_ENGINE_HEADLESS
+            if (_context.eglContext) {
+                eglMakeCurrent(_context.eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, _context.eglContext);
+                return;
+            }
+
+            // Otherwise a current headless context would shadow the window's. A context that
+            // SDL made current through EGL is left to SDL_GL_MakeCurrent.
+            if (is_headless_context(eglGetCurrentContext())) eglMakeCurrent(eglGetCurrentDisplay(), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+#endif
+
+            SDL_GL_MakeCurrent(_context.window, _context.context);
+        }
+
+        context_data current_context() noexcept {
+#if RC_ENGINE_HEADLESS
+            if (auto const context = eglGetCurrentContext(); context != EGL_NO_CONTEXT && is_headless_context(context)) {
+                return context_data{nullptr, nullptr, eglGetCurrentDisplay(), context};
+            }
+#endif
+
+            return context_data{SDL_GL_GetCurrentWindow(), SDL_GL_GetCurrentContext(), nullptr, nullptr};
+        }
+    }    // namespace render_context_detail
+
     render_context::render_context(window const& _window, flags _flags) noexcept(false)
-    : m_context{_window.raw_pointer(impl_call), SDL_GL_CreateContext(_window.raw_pointer(impl_call))} {
+    : m_context{_window.raw_pointer(impl_call), SDL_GL_CreateContext(_window.raw_pointer(impl_call)), nullptr, nullptr} {
         auto l = make_active_lock();
         enable_depth_test();
 
@@ -68,12 +205,107 @@ namespace randomcat::engine::graphics {
         if (is_debug(_flags)) {
             sdlFlags |= SDL_GL_CONTEXT_DEBUG_FLAG;
 
-            log::info << "Context created with debugging";
-
-            glEnable(GL_DEBUG_OUTPUT);
-            glDebugMessageCallback(gl_log_callback, nullptr);
+            m_debugMessages = std::make_unique<gl_debug_messages>();
+            enable_debug_output(*m_debugMessages);
         }
 
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, sdlFlags);
     }
+
+#if RC_ENGINE_HEADLESS
+    render_context::render_context(headless_t, std::int16_t _width, std::int16_t _height, flags _flags) noexcept(false)
+    : m_context(make_headless_context(_flags)) {
+        // The destructor does not run if construction throws, so the context is released here
+        auto constructed = false;
+        auto const destroyOnError = gsl::finally([&] {
+            if (constructed) return;
+
+            {
+                auto l = make_active_lock();
+                m_offscreen.reset();
+            }
+
+            destroy_headless_context(m_context);
+        });
+
+        auto l = make_active_lock();
+
+        // glewInit would look for a GLX display, which a headless machine does not have
+        auto glewErr = glewContextInit();
+        if (glewErr != GLEW_OK) {
+            throw render_context_init_error{"Error initializing GLEW: " + std::string{reinterpret_cast<char const*>(glewGetErrorString(glewErr))}};
+        }
+
+        enable_depth_test();
+        if (is_debug(_flags)) {
+            m_debugMessages = std::make_unique<gl_debug_messages>();
+            enable_debug_output(*m_debugMessages);
+        }
+
+        auto& target = m_offscreen.emplace(offscreen_target{
+            gl_detail::unique_framebuffer_id(), gl_detail::unique_renderbuffer_id(), gl_detail::unique_renderbuffer_id(), _width, _height});
+
+        glBindRenderbuffer(GL_RENDERBUFFER, target.color.value());
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, _width, _height);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depth.value());
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, _width, _height);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, target.framebuffer.value());
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, target.color.value());
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depth.value());
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw render_context_init_error{"Offscreen framebuffer is incomplete"};
+        }
+
+        glViewport(0, 0, _width, _height);
+        constructed = true;
+    }
+#else
+    render_context::render_context(headless_t, std::int16_t, std::int16_t, flags) noexcept(false) {
+        throw render_context_init_error{"Headless rendering requires building with RC_ENGINE_HEADLESS"};
+    }
+#endif
+
+    render_context::~render_context() noexcept {
+        if (m_debugMessages) {
+            // A window's context outlives this object, and must not call back into the freed messages
+            auto l = make_active_lock();
+            glDebugMessageCallback(nullptr, nullptr);
+        }
+
+#if RC_ENGINE_HEADLESS
+        if (!m_offscreen) return;
+
+        {
+            // The framebuffer belongs to this context, so it must be current to delete it
+            auto l = make_active_lock();
+            m_offscreen.reset();
+        }
+
+        destroy_headless_context(m_context);
+#endif
+    }
+
+    void render_context::set_debug_messages_enabled(GLenum _source, GLenum _type, GLenum _severity, bool _enabled) const noexcept {
+        if (!m_debugMessages) return;
+
+        auto l = make_active_lock();
+        glDebugMessageControl(_source, _type, _severity, 0, nullptr, _enabled ? GL_TRUE : GL_FALSE);
+    }
+
+    std::vector<std::uint8_t> render_context::read_pixels() const noexcept(false) {
+        if (!m_offscreen) throw render_context_error{"Only headless contexts can read back their frames"};
+
+        auto pixels = std::vector<std::uint8_t>(std::size_t(m_offscreen->width) * std::size_t(m_offscreen->height) * 4);
+
+        auto l = make_active_lock();
+        bind_render_target();
+
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_offscreen->width, m_offscreen->height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        return pixels;
+    }
 }    // namespace randomcat::engine::graphics
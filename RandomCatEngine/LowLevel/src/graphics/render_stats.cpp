@@ -0,0 +1,10 @@
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
+
+namespace randomcat::engine::graphics {
+    std::ostream& operator<<(std::ostream& _stream, render_stats const& _stats) noexcept(false) {
+        return _stream << _stats.drawCalls << " draws, " << _stats.verticesUploaded << " vertices (" << _stats.vertexBytesUploaded
+                       << " bytes) uploaded, " << _stats.stateBinds << " binds, " << _stats.uniformSets << " uniform sets, "
+                       << _stats.textureUploads << " texture uploads (" << _stats.textureBytesUploaded << " bytes), "
+                       << _stats.shaderCompiles << " shader compiles, " << _stats.debugMessages << " GL debug messages";
+    }
+}    // namespace randomcat::engine::graphics
@@ -0,0 +1,34 @@
+#include "randomcat/engine/low_level/graphics/shader_source.hpp"
+
+#include <algorithm>
+
+namespace randomcat::engine::graphics {
+    std::optional<std::string> insert_shader_declarations(std::string_view _source, std::string_view _declarations, int _minimumVersion) noexcept(false) {
+        using namespace std::string_view_literals;
+
+        auto const directive = "#version"sv;
+        auto const versionBegin = _source.find_first_not_of(" \t\r\n");
+
+        if (versionBegin == std::string_view::npos || _source.substr(versionBegin, directive.size()) != directive) return std::nullopt;
+
+        auto const versionEnd = std::min(_source.find('\n', versionBegin), _source.size());
+
+        auto const numberBegin = std::min(_source.find_first_not_of(" \t", versionBegin + directive.size()), versionEnd);
+        auto const numberEnd = std::min(_source.find_first_not_of("0123456789", numberBegin), versionEnd);
+
+        if (numberBegin == numberEnd) return std::nullopt;
+
+        // GLSL versions have 3 digits; reading at most 4 keeps longer (invalid) ones from
+        // overflowing, and the compiler reports them
+        auto version = 0;
+        for (auto digit : _source.substr(numberBegin, std::min(numberEnd - numberBegin, std::size_t(4)))) version = version * 10 + (digit - '0');
+
+        auto result = std::string(_source.substr(0, numberBegin));
+        result += version < _minimumVersion ? std::to_string(_minimumVersion) : std::string(_source.substr(numberBegin, numberEnd - numberBegin));
+        result += _source.substr(numberEnd, versionEnd - numberEnd);
+        result += _declarations;
+        result += _source.substr(versionEnd);
+
+        return result;
+    }
+}    // namespace randomcat::engine::graphics
@@ -0,0 +1,168 @@
+#include "randomcat/engine/low_level/profiling.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace randomcat::engine::profiling {
+#if RC_ENGINE_PROFILING
+    namespace {
+        void write_json_string(std::ostream& _stream, std::string_view _value) noexcept(false) {
+            _stream << '"';
+
+            for (auto c : _value) {
+                switch (c) {
+                    case '"': _stream << "\\\""; break;
+                    case '\\': _stream << "\\\\"; break;
+                    case '\n': _stream << "\\n"; break;
+                    default: {
+                        if (static_cast<unsigned char>(c) < 0x20) {
+                            _stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec << std::setfill(' ');
+                        } else {
+                            _stream << c;
+                        }
+                    }
+                }
+            }
+
+            _stream << '"';
+        }
+
+        // Trace timestamps are in microseconds
+        void write_microseconds(std::ostream& _stream, std::int64_t _nanoseconds) noexcept(false) {
+            _stream << _nanoseconds / 1000 << '.' << std::setw(3) << std::setfill('0') << _nanoseconds % 1000 << std::setfill(' ');
+        }
+
+        struct registered_thread {
+            std::unique_ptr<profiling_detail::thread_buffer> buffer;
+            std::string name;
+        };
+
+        struct thread_registry {
+            std::mutex mutex;
+            std::vector<registered_thread> threads;
+        };
+
+        // Never destroyed, so that threads still running during static destruction can record
+        thread_registry& registry() noexcept {
+            static auto* const instance = new thread_registry();
+            return *instance;
+        }
+    }    // namespace
+
+    namespace profiling_detail {
+        void thread_buffer::copy_zones(std::vector<zone>& _zones) const noexcept(false) {
+            auto const written = m_written.load(std::memory_order_acquire);
+            auto const first = written > capacity ? written - capacity : 0;
+
+            auto const oldSize = _zones.size();
+
+            for (auto index = first; index < written; ++index) {
+                auto const& event = (*m_events)[index % capacity];
+                _zones.push_back(zone{event.name.load(std::memory_order_relaxed),
+                                      event.begin.load(std::memory_order_relaxed),
+                                      event.end.load(std::memory_order_relaxed)});
+            }
+
+            // Slots that the writer claimed while they were being copied may be torn
+            std::atomic_thread_fence(std::memory_order_acquire);
+            auto const claimed = m_claimed.load(std::memory_order_relaxed);
+            auto const firstIntact = claimed > capacity ? claimed - capacity : 0;
+
+            if (firstIntact > first) {
+                auto const torn = std::min(firstIntact - first, written - first);
+                _zones.erase(_zones.begin() + std::ptrdiff_t(oldSize), _zones.begin() + std::ptrdiff_t(oldSize + torn));
+            }
+        }
+
+        thread_buffer& register_thread() noexcept(false) {
+            auto& threads = registry();
+            auto lock = std::lock_guard(threads.mutex);
+
+            auto const threadID = std::uint32_t(threads.threads.size() + 1);
+            threads.threads.push_back(registered_thread{std::make_unique<thread_buffer>(threadID), "Thread " + std::to_string(threadID)});
+
+            return *threads.threads.back().buffer;
+        }
+    }    // namespace profiling_detail
+
+    void set_thread_name(std::string _name) noexcept(false) {
+        auto const& buffer = profiling_detail::this_thread_buffer();
+
+        auto& threads = registry();
+        auto lock = std::lock_guard(threads.mutex);
+
+        threads.threads[buffer.thread_id() - 1].name = std::move(_name);
+    }
+
+    void write_chrome_trace(std::ostream& _stream) noexcept(false) {
+        struct thread_zones {
+            std::uint32_t threadID;
+            std::string name;
+            std::vector<profiling_detail::thread_buffer::zone> zones;
+        };
+
+        std::vector<thread_zones> threads;
+
+        {
+            auto& registered = registry();
+            auto lock = std::lock_guard(registered.mutex);
+
+            for (auto const& thread : registered.threads) {
+                threads.push_back(thread_zones{thread.buffer->thread_id(), thread.name, {}});
+                thread.buffer->copy_zones(threads.back().zones);
+            }
+        }
+
+        // Relative to the earliest zone, so that timestamps stay short
+        auto origin = std::numeric_limits<std::int64_t>::max();
+        for (auto const& thread : threads) {
+            for (auto const& zone : thread.zones) origin = std::min(origin, zone.begin);
+        }
+
+        _stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+        auto first = true;
+        auto const separator = [&]() -> std::ostream& {
+            if (!first) _stream << ",";
+            first = false;
+            return _stream << "\n";
+        };
+
+        for (auto const& thread : threads) {
+            separator() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << thread.threadID << ",\"args\":{\"name\":";
+            write_json_string(_stream, thread.name);
+            _stream << "}}";
+
+            for (auto const& zone : thread.zones) {
+                separator() << "{\"ph\":\"X\",\"cat\":\"engine\",\"pid\":1,\"tid\":" << thread.threadID << ",\"name\":";
+                write_json_string(_stream, zone.name);
+                _stream << ",\"ts\":";
+                write_microseconds(_stream, zone.begin - origin);
+                _stream << ",\"dur\":";
+                write_microseconds(_stream, zone.end - zone.begin);
+                _stream << "}";
+            }
+        }
+
+        _stream << "\n]}\n";
+    }
+#else
+    void set_thread_name(std::string) noexcept(false) {}
+
+    void write_chrome_trace(std::ostream& _stream) noexcept(false) { _stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[]}\n"; }
+#endif
+
+    void write_chrome_trace(fs::path const& _path) noexcept(false) {
+        auto stream = std::ofstream(_path);
+        if (!stream) throw profiling_error{"Unable to open trace file " + _path.string()};
+
+        write_chrome_trace(stream);
+
+        if (!stream) throw profiling_error{"Error writing trace file " + _path.string()};
+    }
+}    // namespace randomcat::engine::profiling
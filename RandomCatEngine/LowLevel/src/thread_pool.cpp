@@ -0,0 +1,102 @@
+#include "randomcat/engine/low_level/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace randomcat::engine {
+    std::size_t thread_pool::default_worker_count() noexcept {
+        // hardware_concurrency may return 0 if it is unknown
+        return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    }
+
+    thread_pool::thread_pool(std::size_t _workerCount) noexcept(false) {
+        m_workers.reserve(_workerCount);
+
+        try {
+            for (std::size_t i = 0; i < _workerCount; ++i) m_workers.emplace_back([this] { run_worker(); });
+        } catch (...) {
+            // The destructor will not run, so stop the workers that did start
+            stop();
+            throw;
+        }
+    }
+
+    thread_pool::~thread_pool() noexcept { stop(); }
+
+    void thread_pool::stop() noexcept {
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            m_stopping = true;
+        }
+
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers) worker.join();
+        m_workers.clear();
+    }
+
+    void thread_pool::run_tasks(std::size_t _count, void const* _context, task_function _function) noexcept {
+        if (_count == 0) return;
+
+        auto const runLock = std::lock_guard(m_runMutex);
+
+        if (m_workers.empty() || _count == 1) {
+            for (std::size_t i = 0; i < _count; ++i) _function(_context, i);
+            return;
+        }
+
+        {
+            // A worker that woke late for the previous run may still be looking for its tasks
+            auto lock = std::unique_lock(m_mutex);
+            m_idle.wait(lock, [&] { return m_busyWorkers == 0; });
+
+            m_taskCount = _count;
+            m_taskContext = _context;
+            m_taskFunction = _function;
+            m_nextTask.store(0, std::memory_order_relaxed);
+
+            ++m_generation;
+        }
+
+        m_wake.notify_all();
+
+        work();
+
+        // Every task has been claimed, so once no worker is busy every task has returned
+        auto lock = std::unique_lock(m_mutex);
+        m_idle.wait(lock, [&] { return m_busyWorkers == 0; });
+    }
+
+    void thread_pool::run_worker() noexcept {
+        auto seenGeneration = std::uint64_t(0);
+
+        while (true) {
+            {
+                auto lock = std::unique_lock(m_mutex);
+                m_wake.wait(lock, [&] { return m_stopping || m_generation != seenGeneration; });
+
+                if (m_stopping) return;
+
+                seenGeneration = m_generation;
+                ++m_busyWorkers;
+            }
+
+            work();
+
+            {
+                auto const lock = std::lock_guard(m_mutex);
+                if (--m_busyWorkers != 0) continue;
+            }
+
+            m_idle.notify_all();
+        }
+    }
+
+    void thread_pool::work() noexcept {
+        while (true) {
+            auto const index = m_nextTask.fetch_add(1, std::memory_order_relaxed);
+            if (index >= m_taskCount) return;
+
+            m_taskFunction(m_taskContext, index);
+        }
+    }
+}    // namespace randomcat::engine
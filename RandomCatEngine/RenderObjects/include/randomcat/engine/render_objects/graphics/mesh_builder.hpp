@@ -0,0 +1,323 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "randomcat/engine/low_level/thread_pool.hpp"
+#include "randomcat/engine/render_objects/graphics/default_vertex.hpp"
+#include "randomcat/engine/render_objects/graphics/object.hpp"
+
+namespace randomcat::engine::graphics {
+    namespace mesh_builder_detail {
+        template<typename Object, typename = void>
+        struct object_has_fixed_vertex_count_s : std::false_type {};
+
+        template<typename Object>
+        struct object_has_fixed_vertex_count_s<Object, std::void_t<decltype(Object::fixed_vertex_count), typename Object::vertex>> :
+        std::true_type {};
+
+        template<typename Object, typename = void>
+        struct object_has_write_vertices_s : std::false_type {};
+
+        template<typename Object>
+        struct object_has_write_vertices_s<Object,
+                                           std::void_t<decltype(std::declval<Object const&>().write_vertices(std::declval<typename Object::vertex*>()))>> :
+        std::true_type {};
+
+        // Objects that generate their vertices (see render_object_rect_prism<>) write them
+        // without building their sub parts
+        template<typename Target, typename Object>
+        static auto constexpr object_writes_vertices = [] {
+            if constexpr (object_has_write_vertices_s<Object>::value) {
+                return std::is_same_v<typename Object::vertex, Target>;
+            } else {
+                return false;
+            }
+        }();
+
+        template<typename Target, typename Object>
+        Target* write_render_object_vertices(Object const& _obj, Target* _out) noexcept {
+            if constexpr (std::is_same_v<Object, Target>) {
+                *_out = _obj;
+                return _out + 1;
+            } else if constexpr (object_writes_vertices<Target, Object>) {
+                return _obj.write_vertices(_out);
+            } else {
+                decltype(auto) sub = render_object_sub_parts(_obj);
+                for (auto const& part : sub) _out = write_render_object_vertices<Target>(part, _out);
+                return _out;
+            }
+        }
+    }    // namespace mesh_builder_detail
+
+    // Whether every Object decomposes to the same number of Targets, known at compile time.
+    // Render objects opt in with a static fixed_vertex_count.
+    template<typename Target, typename Object>
+    static auto constexpr render_object_has_fixed_vertex_count = [] {
+        if constexpr (std::is_same_v<Object, Target>) {
+            return true;
+        } else if constexpr (mesh_builder_detail::object_has_fixed_vertex_count_s<Object>::value) {
+            return std::is_same_v<typename Object::vertex, Target>;
+        } else {
+            return false;
+        }
+    }();
+
+    template<typename Target, typename Object>
+    static auto constexpr render_object_fixed_vertex_count = [] {
+        static_assert(render_object_has_fixed_vertex_count<Target, Object>, "Object does not have a fixed vertex count");
+
+        if constexpr (std::is_same_v<Object, Target>) {
+            return std::size_t(1);
+        } else {
+            return std::size_t(Object::fixed_vertex_count);
+        }
+    }();
+
+    template<typename Target, typename InputIt>
+    [[nodiscard]] std::size_t render_object_vertex_count(InputIt _begin, InputIt _end) noexcept;
+
+    // The number of Targets that decompose_render_object_to would write for _obj
+    template<typename Target, typename Object>
+    [[nodiscard]] std::size_t render_object_vertex_count(Object const& _obj) noexcept {
+        if constexpr (render_object_has_fixed_vertex_count<Target, Object>) {
+            return render_object_fixed_vertex_count<Target, Object>;
+        } else {
+            decltype(auto) sub = render_object_sub_parts(_obj);
+            return render_object_vertex_count<Target>(begin(sub), end(sub));
+        }
+    }
+
+    template<typename Target, typename InputIt>
+    [[nodiscard]] std::size_t render_object_vertex_count(InputIt _begin, InputIt _end) noexcept {
+        using InputType = typename std::iterator_traits<InputIt>::value_type;
+
+        if constexpr (render_object_has_fixed_vertex_count<Target, InputType>) {
+            return std::size_t(std::distance(_begin, _end)) * render_object_fixed_vertex_count<Target, InputType>;
+        } else {
+            auto count = std::size_t(0);
+            for (; _begin != _end; ++_begin) count += render_object_vertex_count<Target>(*_begin);
+            return count;
+        }
+    }
+
+    // Calls _f with each Target that _obj decomposes to, in the order that
+    // decompose_render_object_to writes them
+    template<typename Target, typename Object, typename F>
+    void for_each_render_object_vertex(Object const& _obj, F&& _f) noexcept {
+        if constexpr (std::is_same_v<Object, Target>) {
+            _f(_obj);
+        } else if constexpr (mesh_builder_detail::object_writes_vertices<Target, Object>) {
+            std::array<Target, render_object_fixed_vertex_count<Target, Object>> vertices;
+            _obj.write_vertices(vertices.data());
+
+            for (auto const& vertex : vertices) _f(vertex);
+        } else {
+            decltype(auto) sub = render_object_sub_parts(_obj);
+            for (auto const& part : sub) for_each_render_object_vertex<Target>(part, _f);
+        }
+    }
+
+    namespace mesh_builder_detail {
+        // Fewer objects than this are not worth handing to another thread
+        static auto constexpr min_objects_per_chunk = std::size_t(256);
+
+        // Decomposes the objects in chunks on _pool's threads. _output is called once with the
+        // total number of Targets, and returns where to write them. Each chunk's Targets start
+        // where the previous chunk's end, so the output is the same as writing sequentially.
+        template<typename Target, typename RandomIt, typename GetOutput>
+        Target* parallel_write_render_object_vertices(thread_pool& _pool, RandomIt _begin, RandomIt _end, GetOutput&& _output) noexcept(!"Allocates") {
+            using InputType = typename std::iterator_traits<RandomIt>::value_type;
+
+            static_assert(std::is_base_of_v<std::random_access_iterator_tag, typename std::iterator_traits<RandomIt>::iterator_category>,
+                          "The objects must be split into chunks");
+
+            auto const objectCount = std::size_t(_end - _begin);
+
+            // Several chunks per thread, so that threads that finish early can take more
+            auto const chunkCount = std::clamp(objectCount / min_objects_per_chunk, std::size_t(1), _pool.thread_count() * 4);
+
+            auto const chunkBegin = [&](std::size_t _chunk) noexcept { return _begin + std::ptrdiff_t(objectCount * _chunk / chunkCount); };
+
+            if (chunkCount == 1) {
+                auto* out = _output(render_object_vertex_count<Target>(_begin, _end));
+                for (; _begin != _end; ++_begin) out = write_render_object_vertices<Target>(*_begin, out);
+                return out;
+            }
+
+            // offsets[i] is where chunk i's Targets start
+            auto offsets = std::vector<std::size_t>(chunkCount + 1);
+
+            if constexpr (render_object_has_fixed_vertex_count<Target, InputType>) {
+                for (std::size_t chunk = 0; chunk <= chunkCount; ++chunk) {
+                    offsets[chunk] = std::size_t(chunkBegin(chunk) - _begin) * render_object_fixed_vertex_count<Target, InputType>;
+                }
+            } else {
+                _pool.run(chunkCount, [&](std::size_t _chunk) noexcept {
+                    offsets[_chunk + 1] = render_object_vertex_count<Target>(chunkBegin(_chunk), chunkBegin(_chunk + 1));
+                });
+
+                std::partial_sum(begin(offsets), end(offsets), begin(offsets));
+            }
+
+            Target* const out = _output(offsets[chunkCount]);
+
+            _pool.run(chunkCount, [&](std::size_t _chunk) noexcept {
+                auto* chunkOut = out + offsets[_chunk];
+
+                for (auto it = chunkBegin(_chunk), chunkEnd = chunkBegin(_chunk + 1); it != chunkEnd; ++it) {
+                    chunkOut = write_render_object_vertices<Target>(*it, chunkOut);
+                }
+            });
+
+            return out + offsets[chunkCount];
+        }
+    }    // namespace mesh_builder_detail
+
+    // As decompose_render_object_to, with the objects split among _pool's threads, for
+    // scenes with too many objects to decompose on one thread each frame. _output must have
+    // room for render_object_vertex_count<Target>(_begin, _end) Targets. The Targets written
+    // are the same, in the same order, as those written by the sequential version.
+    template<typename Target, typename RandomIt>
+    Target* decompose_render_object_to(thread_pool& _pool, RandomIt _begin, RandomIt _end, Target* _output) noexcept(!"Allocates") {
+        return mesh_builder_detail::parallel_write_render_object_vertices<Target>(_pool, _begin, _end, [&](std::size_t) noexcept { return _output; });
+    }
+
+    // Builds the vertex buffer for a frame from render objects. Each add reserves exactly
+    // the space that its objects need and writes their vertices through a raw pointer,
+    // rather than growing the buffer a vertex at a time. The buffer is not initialized
+    // before it is written, which a std::vector would do. Reuse a builder across frames
+    // (calling clear) so that its buffer is only allocated once.
+    //
+    // A builder is a contiguous container of vertices, so it can be passed to a
+    // vertex_renderer as is.
+    template<typename Vertex = default_vertex>
+    class mesh_builder {
+    public:
+        static_assert(std::is_trivially_copyable_v<Vertex> && std::is_trivially_destructible_v<Vertex>,
+                      "Vertices are written to uninitialized storage");
+
+        using vertex = Vertex;
+
+        void clear() noexcept { m_size = 0; }
+
+        void reserve(std::size_t _capacity) noexcept(!"Allocates") {
+            if (_capacity <= m_capacity) return;
+
+            // Grow geometrically, so that repeated adds do not reallocate each time
+            auto const newCapacity = std::max(_capacity, m_capacity * 2);
+            auto newVertices = std::unique_ptr<vertex[]>(new vertex[newCapacity]);
+            std::copy_n(m_vertices.get(), m_size, newVertices.get());
+
+            m_vertices = std::move(newVertices);
+            m_capacity = newCapacity;
+        }
+
+        template<typename InputIt>
+        void add(InputIt _begin, InputIt _end) noexcept(!"Allocates") {
+            reserve(m_size + render_object_vertex_count<vertex>(_begin, _end));
+
+            auto* out = m_vertices.get() + m_size;
+            for (; _begin != _end; ++_begin) out = mesh_builder_detail::write_render_object_vertices<vertex>(*_begin, out);
+
+            m_size = std::size_t(out - m_vertices.get());
+        }
+
+        template<typename Object>
+        void add(Object const& _obj) noexcept(!"Allocates") {
+            add(std::addressof(_obj), std::addressof(_obj) + 1);
+        }
+
+        // As add, with the objects split among _pool's threads (see the parallel
+        // decompose_render_object_to)
+        template<typename RandomIt>
+        void add(thread_pool& _pool, RandomIt _begin, RandomIt _end) noexcept(!"Allocates") {
+            auto* const written = mesh_builder_detail::parallel_write_render_object_vertices<vertex>(_pool, _begin, _end, [&](std::size_t _count) {
+                reserve(m_size + _count);
+                return m_vertices.get() + m_size;
+            });
+
+            m_size = std::size_t(written - m_vertices.get());
+        }
+
+        [[nodiscard]] vertex const* data() const noexcept { return m_vertices.get(); }
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+        [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+
+        [[nodiscard]] vertex const* begin() const noexcept { return data(); }
+        [[nodiscard]] vertex const* end() const noexcept { return data() + size(); }
+
+        [[nodiscard]] vertex const& operator[](std::size_t _index) const noexcept { return m_vertices[_index]; }
+
+    private:
+        std::unique_ptr<vertex[]> m_vertices;
+        std::size_t m_size = 0;
+        std::size_t m_capacity = 0;
+    };
+
+    // The vertices of render objects as separate arrays, one per attribute, for CPU-side
+    // work (bounds, culling, picking) that only reads some attributes. Vertices are
+    // expected to have the members of default_vertex.
+    class mesh_streams {
+    public:
+        void clear() noexcept {
+            m_locations.clear();
+            m_textureCoords.clear();
+            m_textureLayers.clear();
+            m_normals.clear();
+        }
+
+        template<typename InputIt>
+        void add(InputIt _begin, InputIt _end) noexcept(!"Allocates") {
+            using vertex = typename std::iterator_traits<InputIt>::value_type::vertex;
+
+            auto const oldSize = size();
+            auto const newSize = oldSize + render_object_vertex_count<vertex>(_begin, _end);
+
+            m_locations.resize(newSize);
+            m_textureCoords.resize(newSize);
+            m_textureLayers.resize(newSize);
+            m_normals.resize(newSize);
+
+            auto* locations = m_locations.data() + oldSize;
+            auto* textureCoords = m_textureCoords.data() + oldSize;
+            auto* textureLayers = m_textureLayers.data() + oldSize;
+            auto* normals = m_normals.data() + oldSize;
+
+            auto const write = [&](vertex const& _vertex) noexcept {
+                *locations++ = _vertex.location.value;
+                *textureCoords++ = _vertex.texture.coord;
+                *textureLayers++ = _vertex.texture.layer;
+                *normals++ = _vertex.normal;
+            };
+
+            for (; _begin != _end; ++_begin) for_each_render_object_vertex<vertex>(*_begin, write);
+        }
+
+        template<typename Object>
+        void add(Object const& _obj) noexcept(!"Allocates") {
+            add(std::addressof(_obj), std::addressof(_obj) + 1);
+        }
+
+        [[nodiscard]] auto const& locations() const noexcept { return m_locations; }
+        [[nodiscard]] auto const& texture_coords() const noexcept { return m_textureCoords; }
+        [[nodiscard]] auto const& texture_layers() const noexcept { return m_textureLayers; }
+        [[nodiscard]] auto const& normals() const noexcept { return m_normals; }
+
+        [[nodiscard]] auto size() const noexcept { return m_locations.size(); }
+
+    private:
+        std::vector<glm::vec3> m_locations;
+        std::vector<glm::vec2> m_textureCoords;
+        std::vector<texture_array_index> m_textureLayers;
+        std::vector<glm::vec3> m_normals;
+    };
+}    // namespace randomcat::engine::graphics
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <functional>
 
 #include <glm/glm.hpp>
 
@@ -143,6 +145,8 @@ namespace randomcat::engine::graphics {
         public:
             using vertex = Vertex;
 
+            static auto constexpr fixed_vertex_count = std::size_t(3);
+
             render_object_triangle_base(vertex _first, vertex _second, vertex _third) noexcept
             : m_vertices{std::move(_first), std::move(_second), std::move(_third)} {}
 
@@ -201,6 +205,8 @@ namespace randomcat::engine::graphics {
             using vertex = Vertex;
             using triangle = render_object_triangle<vertex>;
 
+            static auto constexpr fixed_vertex_count = std::size_t(6);
+
             render_object_rectangle_base(vertex _first, vertex _second, vertex _third, vertex _fourth) noexcept
             : m_triangles{{{_first, _second, _third}, {_first, _third, _fourth}}} {}
 
@@ -257,6 +263,8 @@ namespace randomcat::engine::graphics {
             using vertex = Vertex;
             using container = std::array<render_object_rectangle<vertex>, 6>;
 
+            static auto constexpr fixed_vertex_count = std::size_t(36);
+
             auto const& sides() const noexcept { return m_rectangles; }
             auto center() const noexcept { return m_center; }
 
@@ -291,10 +299,42 @@ namespace randomcat::engine::graphics {
         using render_object_detail::render_object_rect_prism_base<vertex>::render_object_rect_prism_base;
     };
 
+    namespace render_object_detail::rect_prism_faces {
+        // The faces of a render_object_rect_prism<>, in the order that it writes them: high
+        // and low Z, then Y, then low and high X. Corner i of the prism is at the high end of
+        // X if bit 2 of i is set, of Y if bit 1 is set and of Z if bit 0 is set. Corner k of a
+        // face takes corner k of the face's texture quad.
+        static auto constexpr face_count = std::size_t(6);
+
+        static constexpr std::size_t face_corners[face_count][4] = {{0b011, 0b111, 0b101, 0b001},
+                                                                     {0b110, 0b010, 0b000, 0b100},
+                                                                     {0b111, 0b011, 0b010, 0b110},
+                                                                     {0b100, 0b000, 0b001, 0b101},
+                                                                     {0b010, 0b011, 0b001, 0b000},
+                                                                     {0b111, 0b110, 0b100, 0b101}};
+
+        // The faces are axis-aligned, so their normals need not be computed from the corners
+        static constexpr float face_normals[face_count][3] = {{0, 0, 1}, {0, 0, -1}, {0, 1, 0}, {0, -1, 0}, {-1, 0, 0}, {1, 0, 0}};
+
+        // Which of the render_object_rect_prism<> constructor's textures (high X, low X, high
+        // Y, low Y, high Z, low Z) each face takes
+        static constexpr std::size_t face_textures[face_count] = {4, 5, 2, 3, 1, 0};
+
+        // The order in which each face's corners are written, as render_object_rectangle
+        // splits a quad
+        static constexpr std::size_t triangle_corners[6] = {0, 1, 2, 0, 2, 3};
+    }    // namespace render_object_detail::rect_prism_faces
+
+    // Stores only its parameters (about a sixth of the size of the 36 vertices it stands
+    // for) and generates its vertices when decomposed. sides() builds the faces on demand.
     template<>
-    class render_object_rect_prism<> : public render_object_detail::render_object_rect_prism_base<default_vertex> {
+    class render_object_rect_prism<> {
     public:
         using vertex = default_vertex;
+        using rectangle = render_object_rectangle<vertex>;
+
+        // 6 faces of 2 triangles
+        static auto constexpr fixed_vertex_count = std::size_t(36);
 
         explicit render_object_rect_prism(glm::vec3 _center, glm::vec3 _sides, textures::texture_quad _texture) noexcept
         : render_object_rect_prism(_center, _sides, _texture, _texture, _texture, _texture, _texture, _texture) {}
@@ -307,61 +347,94 @@ namespace randomcat::engine::graphics {
                                           textures::texture_quad _texLY,
                                           textures::texture_quad _texHZ,
                                           textures::texture_quad _texLZ) noexcept
-        : render_object_detail::render_object_rect_prism_base<default_vertex>(impl_call,
-                                                                              gen_triangles(_center, _sides, _texHX, _texLX, _texHY, _texLY, _texHZ, _texLZ),
-                                                                              _center) {}
+        : m_center(std::move(_center)),
+          m_dimensions(std::move(_sides)),
+          m_textures{std::move(_texHZ), std::move(_texLZ), std::move(_texHY), std::move(_texLY), std::move(_texLX), std::move(_texHX)} {}
 
-    private:
-        using rectangle = render_object_rectangle<vertex>;
+        auto center() const noexcept { return m_center; }
+        auto dimensions() const noexcept { return m_dimensions; }
 
-        std::array<rectangle, 6> gen_triangles(glm::vec3 _center,
-                                               glm::vec3 _sides,
-                                               textures::texture_quad _texHX,
-                                               textures::texture_quad _texLX,
-                                               textures::texture_quad _texHY,
-                                               textures::texture_quad _texLY,
-                                               textures::texture_quad _texHZ,
-                                               textures::texture_quad _texLZ) const noexcept {
-            auto vecHX = glm::vec3{_sides.x / 2, 0, 0};
-            auto vecHY = glm::vec3{0, _sides.y / 2, 0};
-            auto vecHZ = glm::vec3{0, 0, _sides.z / 2};
-            auto vecLX = -vecHX;
-            auto vecLY = -vecHY;
-            auto vecLZ = -vecHZ;
-
-            // Sorry for the macro, takes L and H (low and high) and generates corners
-            // of the cubes
-
-#define RC_POINT_GEN(x, y, z) auto point##x##X##y##Y##z##Z = _center + vec##x##X + vec##y##Y + vec##z##Z;
-
-            RC_POINT_GEN(L, L, L);
-            RC_POINT_GEN(L, L, H);
-            RC_POINT_GEN(L, H, L);
-            RC_POINT_GEN(L, H, H);
-            RC_POINT_GEN(H, L, L);
-            RC_POINT_GEN(H, L, H);
-            RC_POINT_GEN(H, H, L);
-            RC_POINT_GEN(H, H, H);
-
-#undef RC_POINT_GEN
-
-            auto location = [](glm::vec3 posA, glm::vec3 posB, glm::vec3 posC, glm::vec3 posD) noexcept {
-                return location_quad{{posA}, {posB}, {posC}, {posD}};
+        std::array<rectangle, 6> sides() const noexcept {
+            auto const corners = gen_corners();
+
+            auto side = [&](std::size_t _face) noexcept {
+                auto const vertex = [&](std::size_t _corner) noexcept {
+                    auto result = render_object_rect_prism::vertex{};
+                    write_face_vertex(result, corners, _face, _corner);
+                    return result;
+                };
+
+                return rectangle{impl_call, {vertex(0), vertex(1), vertex(2)}, {vertex(0), vertex(2), vertex(3)}};
             };
 
-            auto texture = [&](textures::texture_quad texture) noexcept { return texture; };
+            return {side(0), side(1), side(2), side(3), side(4), side(5)};
+        }
+
+        RC_SUB_PARTS(sides);
+
+        // Writes fixed_vertex_count vertices to _out, in the order that decomposing sides()
+        // gives them, and returns the end of what was written
+        vertex* write_vertices(vertex* _out) const noexcept {
+            auto const corners = gen_corners();
+
+            for (std::size_t face = 0; face < face_count; ++face) {
+                for (auto corner : render_object_detail::rect_prism_faces::triangle_corners) write_face_vertex(*_out++, corners, face, corner);
+            }
+
+            return _out;
+        }
+
+        template<typename NewVertex, typename F>
+        auto use_vertex(F&& _f) const noexcept {
+            auto const rectangles = sides();
+
+            return render_object_rect_prism<NewVertex>(impl_call,
+                                                       std::array<render_object_rectangle<NewVertex>,
+                                                                  6>{rectangles[0].template use_vertex<NewVertex>(std::forward<F>(_f)),
+                                                                     rectangles[1].template use_vertex<NewVertex>(std::forward<F>(_f)),
+                                                                     rectangles[2].template use_vertex<NewVertex>(std::forward<F>(_f)),
+                                                                     rectangles[3].template use_vertex<NewVertex>(std::forward<F>(_f)),
+                                                                     rectangles[4].template use_vertex<NewVertex>(std::forward<F>(_f)),
+                                                                     rectangles[5].template use_vertex<NewVertex>(std::forward<F>(_f))},
+                                                       m_center);
+        }
+
+    private:
+        static auto constexpr face_count = render_object_detail::rect_prism_faces::face_count;
 
-            auto rectHZ = rectangle{location(pointLXHYHZ, pointHXHYHZ, pointHXLYHZ, pointLXLYHZ), texture(_texHZ)};
-            auto rectLZ = rectangle{location(pointHXHYLZ, pointLXHYLZ, pointLXLYLZ, pointHXLYLZ), texture(_texLZ)};
+        // Indexed as in render_object_detail::rect_prism_faces
+        using corners = std::array<glm::vec3, 8>;
 
-            auto rectHX = rectangle{location(pointHXHYHZ, pointHXHYLZ, pointHXLYLZ, pointHXLYHZ), texture(_texHX)};
-            auto rectLX = rectangle{location(pointLXHYLZ, pointLXHYHZ, pointLXLYHZ, pointLXLYLZ), texture(_texLX)};
+        corners gen_corners() const noexcept {
+            auto const half = m_dimensions / 2.0f;
 
-            auto rectHY = rectangle{location(pointHXHYHZ, pointLXHYHZ, pointLXHYLZ, pointHXHYLZ), texture(_texHY)};
-            auto rectLY = rectangle{location(pointHXLYLZ, pointLXLYLZ, pointLXLYHZ, pointHXLYHZ), texture(_texLY)};
+            corners result;
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                result[i] = m_center + glm::vec3{(i & 4) ? half.x : -half.x, (i & 2) ? half.y : -half.y, (i & 1) ? half.z : -half.z};
+            }
 
-            return {rectHZ, rectLZ, rectHY, rectLY, rectLX, rectHX};
+            return result;
         }
+
+        // Corner _corner of _face, which takes corner _corner of the face's texture. Writes
+        // each member in place, as building a vertex and copying it is far slower.
+        void write_face_vertex(vertex& _out, corners const& _corners, std::size_t _face, std::size_t _corner) const noexcept {
+            using namespace render_object_detail::rect_prism_faces;
+
+            auto const& texture = m_textures[_face];
+            auto const& normal = face_normals[_face];
+
+            _out.location.value = _corners[face_corners[_face][_corner]];
+            _out.texture.coord = texture[std::ptrdiff_t(_corner)];
+            _out.texture.layer = texture.layer();
+            _out.normal = glm::vec3{normal[0], normal[1], normal[2]};
+        }
+
+        glm::vec3 m_center;
+        glm::vec3 m_dimensions;
+
+        // High and low Z, then Y, then low and high X
+        std::array<textures::texture_quad, face_count> m_textures;
     };
 
     template<typename Vertex = default_vertex>
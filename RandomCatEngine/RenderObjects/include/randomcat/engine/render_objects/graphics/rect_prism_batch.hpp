@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+#include "randomcat/engine/render_objects/graphics/default_vertex.hpp"
+#include "randomcat/engine/textures/graphics/texture_sections.hpp"
+
+// Generates the vertices of many rectangular prisms or cubes at once, from arrays of
+// their parameters, for when there are too many to construct render objects one at a
+// time each frame. Gives the same vertices as constructing render_object_rect_prism<>s
+// (or render_object_cube<>s) and decomposing them.
+//
+// Like image_kernels, there is a scalar implementation and, on x86, SSE2 and AVX2
+// implementations selected at runtime for the running CPU. Passing an explicit isa
+// forces a particular implementation, falling back to the best supported one below it;
+// this exists for benchmarks and testing.
+
+namespace randomcat::engine::graphics::rect_prism_batch {
+    enum class isa { scalar, sse2, avx2 };
+
+    // The best implementation supported by the running CPU
+    [[nodiscard]] isa best_isa() noexcept;
+
+    // The number of vertices written for each prism
+    static auto constexpr vertices_per_prism = std::size_t(36);
+
+    enum class texture_layout {
+        // One texture quad per prism, used for every face
+        per_prism,
+
+        // Six texture quads per prism, in the order that the render_object_rect_prism<>
+        // constructor takes them: high X, low X, high Y, low Y, high Z, low Z
+        per_face,
+    };
+
+    // Writes vertices_per_prism * _count vertices to _out and returns the end of what was
+    // written. _dimensions are the full lengths of the sides.
+    default_vertex* write_rect_prisms(default_vertex* _out,
+                                      std::size_t _count,
+                                      glm::vec3 const* _centers,
+                                      glm::vec3 const* _dimensions,
+                                      textures::texture_quad const* _textures,
+                                      texture_layout _layout = texture_layout::per_prism,
+                                      isa _isa = best_isa()) noexcept;
+
+    // As write_rect_prisms, with every side of each prism _sides[i] long
+    default_vertex* write_cubes(default_vertex* _out,
+                                std::size_t _count,
+                                glm::vec3 const* _centers,
+                                float const* _sides,
+                                textures::texture_quad const* _textures,
+                                texture_layout _layout = texture_layout::per_prism,
+                                isa _isa = best_isa()) noexcept;
+}    // namespace randomcat::engine::graphics::rect_prism_batch
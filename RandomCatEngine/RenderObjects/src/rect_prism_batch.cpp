@@ -0,0 +1,283 @@
+#include "randomcat/engine/render_objects/graphics/rect_prism_batch.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+#include "randomcat/engine/low_level/detail/cpu_features.hpp"
+#include "randomcat/engine/render_objects/graphics/object.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define RC_RECT_PRISM_BATCH_X86 1
+#    include <immintrin.h>
+#else
+#    define RC_RECT_PRISM_BATCH_X86 0
+#endif
+
+namespace randomcat::engine::graphics::rect_prism_batch {
+    namespace {
+        using namespace render_object_detail::rect_prism_faces;
+
+        static_assert(render_object_rect_prism<>::fixed_vertex_count == vertices_per_prism);
+
+        [[nodiscard]] isa effective_isa(isa _requested) noexcept {
+            auto const best = best_isa();
+            return _requested > best ? best : _requested;
+        }
+
+        [[nodiscard]] std::size_t textures_per_prism(texture_layout _layout) noexcept { return _layout == texture_layout::per_face ? 6 : 1; }
+
+        // The texture of the _face'th face written, of a prism whose textures start at _textures
+        [[nodiscard]] textures::texture_quad const& face_texture(textures::texture_quad const* _textures, std::size_t _face, texture_layout _layout) noexcept {
+            return _layout == texture_layout::per_face ? _textures[face_textures[_face]] : _textures[0];
+        }
+
+        // Exactly one of _dimensions and _sides is non-null
+        [[nodiscard]] glm::vec3 prism_dimensions(glm::vec3 const* _dimensions, float const* _sides, std::size_t _index) noexcept {
+            return _dimensions ? _dimensions[_index] : glm::vec3{_sides[_index], _sides[_index], _sides[_index]};
+        }
+
+        namespace scalar {
+            default_vertex* write_prisms(default_vertex* _out,
+                                         std::size_t _count,
+                                         glm::vec3 const* _centers,
+                                         glm::vec3 const* _dimensions,
+                                         float const* _sides,
+                                         textures::texture_quad const* _textures,
+                                         texture_layout _layout) noexcept {
+                auto const textureStride = textures_per_prism(_layout);
+
+                for (std::size_t i = 0; i < _count; ++i) {
+                    auto const* textures = _textures + i * textureStride;
+                    auto const& texture = [&](std::size_t _index) noexcept -> auto const& { return textures[_layout == texture_layout::per_face ? _index : 0]; };
+
+                    _out = render_object_rect_prism<>(_centers[i],
+                                                      prism_dimensions(_dimensions, _sides, i),
+                                                      texture(0),
+                                                      texture(1),
+                                                      texture(2),
+                                                      texture(3),
+                                                      texture(4),
+                                                      texture(5))
+                               .write_vertices(_out);
+                }
+
+                return _out;
+            }
+        }    // namespace scalar
+
+#if RC_RECT_PRISM_BATCH_X86
+        // The vertex layout that the vector implementations write: location, texture
+        // coordinate, layer and normal, 9 packed 4-byte values in all
+        static_assert(sizeof(default_vertex) == 9 * sizeof(float));
+        static_assert(offsetof(default_vertex, location) == 0);
+        static_assert(offsetof(default_vertex, texture) + offsetof(default_vertex::texture_t, coord) == 3 * sizeof(float));
+        static_assert(offsetof(default_vertex, texture) + offsetof(default_vertex::texture_t, layer) == 5 * sizeof(float));
+        static_assert(offsetof(default_vertex, normal) == 6 * sizeof(float));
+
+        // For each face corner, the sign bits that take the center to that corner when
+        // applied to half of the dimensions. The fourth lane is left clear.
+        struct corner_sign_masks {
+            alignas(32) std::uint32_t values[face_count][4][4];
+        };
+
+        constexpr corner_sign_masks make_corner_sign_masks() noexcept {
+            auto result = corner_sign_masks{};
+
+            for (std::size_t face = 0; face < face_count; ++face) {
+                for (std::size_t corner = 0; corner < 4; ++corner) {
+                    auto const prismCorner = face_corners[face][corner];
+
+                    result.values[face][corner][0] = (prismCorner & 4) ? 0 : 0x80000000u;
+                    result.values[face][corner][1] = (prismCorner & 2) ? 0 : 0x80000000u;
+                    result.values[face][corner][2] = (prismCorner & 1) ? 0 : 0x80000000u;
+                    result.values[face][corner][3] = 0;
+                }
+            }
+
+            return result;
+        }
+
+        static auto constexpr corner_signs = make_corner_sign_masks();
+
+        [[nodiscard]] float layer_bits(textures::texture_quad const& _texture) noexcept {
+            auto const layer = _texture.layer().value;
+            static_assert(sizeof(layer) == sizeof(float));
+
+            float result;
+            std::memcpy(&result, &layer, sizeof(result));
+            return result;
+        }
+
+        namespace sse2 {
+            // Each vertex is written as two 4-value stores (location and texture x, then
+            // texture y, layer and normal x and y) and a store of normal z
+            __attribute__((target("sse2"))) float* write_prism(float* _out,
+                                                                glm::vec3 _center,
+                                                                glm::vec3 _dimensions,
+                                                                textures::texture_quad const* _textures,
+                                                                texture_layout _layout) noexcept {
+                auto const center = _mm_setr_ps(_center.x, _center.y, _center.z, 0);
+                auto const half = _mm_mul_ps(_mm_setr_ps(_dimensions.x, _dimensions.y, _dimensions.z, 0), _mm_set1_ps(0.5f));
+
+                for (std::size_t face = 0; face < face_count; ++face) {
+                    auto const& texture = face_texture(_textures, face, _layout);
+                    auto const layer = layer_bits(texture);
+                    auto const& normal = face_normals[face];
+
+                    __m128 low[4];
+                    __m128 high[4];
+
+                    for (std::size_t corner = 0; corner < 4; ++corner) {
+                        auto const signs = _mm_load_ps(reinterpret_cast<float const*>(corner_signs.values[face][corner]));
+                        auto const location = _mm_add_ps(center, _mm_xor_ps(half, signs));
+
+                        // The location's fourth lane is +0, so this sets it to the texture x exactly
+                        low[corner] = _mm_or_ps(location, _mm_setr_ps(0, 0, 0, texture[std::ptrdiff_t(corner)].x));
+                        high[corner] = _mm_setr_ps(texture[std::ptrdiff_t(corner)].y, layer, normal[0], normal[1]);
+                    }
+
+                    auto const normalZ = _mm_set_ss(normal[2]);
+
+                    for (auto corner : triangle_corners) {
+                        _mm_storeu_ps(_out, low[corner]);
+                        _mm_storeu_ps(_out + 4, high[corner]);
+                        _mm_store_ss(_out + 8, normalZ);
+                        _out += 9;
+                    }
+                }
+
+                return _out;
+            }
+
+            __attribute__((target("sse2"))) default_vertex* write_prisms(default_vertex* _out,
+                                                                         std::size_t _count,
+                                                                         glm::vec3 const* _centers,
+                                                                         glm::vec3 const* _dimensions,
+                                                                         float const* _sides,
+                                                                         textures::texture_quad const* _textures,
+                                                                         texture_layout _layout) noexcept {
+                auto const textureStride = textures_per_prism(_layout);
+                auto* out = reinterpret_cast<float*>(_out);
+
+                for (std::size_t i = 0; i < _count; ++i) {
+                    out = write_prism(out, _centers[i], prism_dimensions(_dimensions, _sides, i), _textures + i * textureStride, _layout);
+                }
+
+                return _out + _count * vertices_per_prism;
+            }
+        }    // namespace sse2
+
+        namespace avx2 {
+            // Two corners at a time; each vertex is then written as one 8-value store and a
+            // store of normal z
+            __attribute__((target("avx2"))) float* write_prism(float* _out,
+                                                                glm::vec3 _center,
+                                                                glm::vec3 _dimensions,
+                                                                textures::texture_quad const* _textures,
+                                                                texture_layout _layout) noexcept {
+                auto const center = _mm256_setr_ps(_center.x, _center.y, _center.z, 0, _center.x, _center.y, _center.z, 0);
+                auto const half = _mm256_mul_ps(_mm256_setr_ps(_dimensions.x, _dimensions.y, _dimensions.z, 0, _dimensions.x, _dimensions.y, _dimensions.z, 0),
+                                                _mm256_set1_ps(0.5f));
+
+                for (std::size_t face = 0; face < face_count; ++face) {
+                    auto const& texture = face_texture(_textures, face, _layout);
+                    auto const layer = layer_bits(texture);
+                    auto const& normal = face_normals[face];
+
+                    __m256 vertices[4];
+
+                    for (std::size_t corner = 0; corner < 4; corner += 2) {
+                        auto const& first = texture[std::ptrdiff_t(corner)];
+                        auto const& second = texture[std::ptrdiff_t(corner + 1)];
+
+                        auto const signs = _mm256_load_ps(reinterpret_cast<float const*>(corner_signs.values[face][corner]));
+                        auto const locations = _mm256_add_ps(center, _mm256_xor_ps(half, signs));
+
+                        // The locations' fourth lanes are +0, so this sets them to the texture x exactly
+                        auto const low = _mm256_or_ps(locations, _mm256_setr_ps(0, 0, 0, first.x, 0, 0, 0, second.x));
+                        auto const high = _mm256_setr_ps(first.y, layer, normal[0], normal[1], second.y, layer, normal[0], normal[1]);
+
+                        vertices[corner] = _mm256_permute2f128_ps(low, high, 0x20);
+                        vertices[corner + 1] = _mm256_permute2f128_ps(low, high, 0x31);
+                    }
+
+                    auto const normalZ = _mm_set_ss(normal[2]);
+
+                    for (auto corner : triangle_corners) {
+                        _mm256_storeu_ps(_out, vertices[corner]);
+                        _mm_store_ss(_out + 8, normalZ);
+                        _out += 9;
+                    }
+                }
+
+                return _out;
+            }
+
+            __attribute__((target("avx2"))) default_vertex* write_prisms(default_vertex* _out,
+                                                                         std::size_t _count,
+                                                                         glm::vec3 const* _centers,
+                                                                         glm::vec3 const* _dimensions,
+                                                                         float const* _sides,
+                                                                         textures::texture_quad const* _textures,
+                                                                         texture_layout _layout) noexcept {
+                auto const textureStride = textures_per_prism(_layout);
+                auto* out = reinterpret_cast<float*>(_out);
+
+                for (std::size_t i = 0; i < _count; ++i) {
+                    out = write_prism(out, _centers[i], prism_dimensions(_dimensions, _sides, i), _textures + i * textureStride, _layout);
+                }
+
+                return _out + _count * vertices_per_prism;
+            }
+        }    // namespace avx2
+#endif
+
+        default_vertex* write_prisms(default_vertex* _out,
+                                     std::size_t _count,
+                                     glm::vec3 const* _centers,
+                                     glm::vec3 const* _dimensions,
+                                     float const* _sides,
+                                     textures::texture_quad const* _textures,
+                                     texture_layout _layout,
+                                     isa _isa) noexcept {
+            switch (effective_isa(_isa)) {
+#if RC_RECT_PRISM_BATCH_X86
+                case isa::avx2: return avx2::write_prisms(_out, _count, _centers, _dimensions, _sides, _textures, _layout);
+                case isa::sse2: return sse2::write_prisms(_out, _count, _centers, _dimensions, _sides, _textures, _layout);
+#endif
+                default: return scalar::write_prisms(_out, _count, _centers, _dimensions, _sides, _textures, _layout);
+            }
+        }
+    }    // namespace
+
+    isa best_isa() noexcept {
+#if RC_RECT_PRISM_BATCH_X86
+        auto const& features = util_detail::detected_cpu_features();
+
+        if (features.avx2) return isa::avx2;
+        if (features.sse2) return isa::sse2;
+#endif
+
+        return isa::scalar;
+    }
+
+    default_vertex* write_rect_prisms(default_vertex* _out,
+                                      std::size_t _count,
+                                      glm::vec3 const* _centers,
+                                      glm::vec3 const* _dimensions,
+                                      textures::texture_quad const* _textures,
+                                      texture_layout _layout,
+                                      isa _isa) noexcept {
+        return write_prisms(_out, _count, _centers, _dimensions, nullptr, _textures, _layout, _isa);
+    }
+
+    default_vertex* write_cubes(default_vertex* _out,
+                                std::size_t _count,
+                                glm::vec3 const* _centers,
+                                float const* _sides,
+                                textures::texture_quad const* _textures,
+                                texture_layout _layout,
+                                isa _isa) noexcept {
+        return write_prisms(_out, _count, _centers, nullptr, _sides, _textures, _layout, _isa);
+    }
+}    // namespace randomcat::engine::graphics::rect_prism_batch
@@ -1,22 +1,19 @@
 #pragma once
 
+#include <memory>
+
 #include "randomcat/engine/low_level/graphics/color.hpp"
+#include "randomcat/engine/textures/graphics/image_kernels.hpp"
 #include "randomcat/engine/textures/graphics/texture.hpp"
 
 namespace randomcat::engine::graphics::textures {
-    texture color_texture(texture::dimension_t _width, texture::dimension_t _height, color_rgba _color) {
-        auto const channels = texture::channels;
-        auto const size = _width * _height * channels;
-        auto data = std::make_unique<unsigned char[]>(size);
-
+    inline texture color_texture(texture::dimension_t _width, texture::dimension_t _height, color_rgba _color) {
         using T = unsigned char;
 
-        for (auto i = 0; i < (_width * _height); ++i) {
-            data[i * channels + 0] = T(_color.r * 255);
-            data[i * channels + 1] = T(_color.g * 255);
-            data[i * channels + 2] = T(_color.b * 255);
-            data[i * channels + 3] = T(_color.a * 255);
-        }
+        auto const pixels = std::size_t(_width) * std::size_t(_height);
+        auto data = std::unique_ptr<T[]>(new T[pixels * texture::channels]);
+
+        image_kernels::fill_rgba(data.get(), pixels, {T(_color.r * 255), T(_color.g * 255), T(_color.b * 255), T(_color.a * 255)});
 
         return texture(impl_call, _width, _height, texture::take_ownership, std::move(data));
     }
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <randomcat/util/require_filesystem.hpp>
+
+#include "randomcat/engine/low_level/graphics/shader.hpp"
+#include "randomcat/engine/textures/graphics/texture_array_index.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+#include "randomcat/engine/textures/graphics/texture_manager.hpp"
+
+#if RC_ENGINE_HOT_RELOAD
+#    include <atomic>
+#    include <mutex>
+#    include <optional>
+#    include <thread>
+#    include <unordered_map>
+#    include <vector>
+
+#    include "randomcat/engine/low_level/file_watcher.hpp"
+#endif
+
+// Reloads textures and shaders when their files change. Files are re-read (and textures
+// re-decoded) on a background thread; the results are swapped in by apply_pending, which
+// must be called on the GL thread between frames. Assets that fail to load are logged
+// and keep their old contents.
+//
+// Only built when the RC_ENGINE_HOT_RELOAD CMake option is on. Otherwise hot_reloader
+// is empty and every member does nothing, so it can be left in release builds.
+
+namespace randomcat::engine::graphics::textures {
+#if RC_ENGINE_HOT_RELOAD
+    class hot_reloader {
+    public:
+        static auto constexpr enabled = true;
+
+        using source_transform = std::function<std::string(std::string_view _source)>;
+
+        hot_reloader() noexcept(!"Throws on error");
+        ~hot_reloader() noexcept;
+
+        hot_reloader(hot_reloader const&) = delete;
+        hot_reloader(hot_reloader&&) = delete;
+
+        hot_reloader& operator=(hot_reloader const&) = delete;
+        hot_reloader& operator=(hot_reloader&&) = delete;
+
+        // Replaces the texture that load_texture_file(_manager, _path) added. _manager must
+        // outlive this.
+        void watch_texture(texture_manager& _manager, fs::path const& _path) noexcept(!"Throws on error");
+
+        // As above, and also re-uploads _layer of _array, which must outlive this. The
+        // texture must keep its size, since rectangles already in vertices depend on it.
+        void watch_texture(texture_manager& _manager, fs::path const& _path, unique_texture_array const& _array, texture_array_index _layer) noexcept(
+            !"Throws on error");
+
+        // Relinks the shader from the two files. _onReload is called afterwards, since
+        // relinking resets uniforms. If given, _transform is applied to each file's contents
+        // (on the GL thread) before relinking; shaders whose sources were prepared, e.g. by
+        // texture_table::prepare_shader_source, must pass the same preparation here.
+        template<typename Vertex, typename Capabilities>
+        void watch_shader(shader_view<Vertex, Capabilities> _shader,
+                          fs::path const& _vertexPath,
+                          fs::path const& _fragmentPath,
+                          std::function<void()> _onReload = {},
+                          source_transform _transform = {}) noexcept(!"Throws on error") {
+            add_shader_watch(
+                [shader = std::move(_shader), transform = std::move(_transform)](std::string_view _vertex, std::string_view _fragment) {
+                    if (transform) {
+                        shader.relink(transform(_vertex), transform(_fragment));
+                    } else {
+                        shader.relink(_vertex, _fragment);
+                    }
+                },
+                _vertexPath,
+                _fragmentPath,
+                std::move(_onReload));
+        }
+
+        template<typename Vertex, typename Capabilities>
+        void watch_shader(shader<Vertex, Capabilities> const& _shader,
+                          fs::path const& _vertexPath,
+                          fs::path const& _fragmentPath,
+                          std::function<void()> _onReload = {},
+                          source_transform _transform = {}) noexcept(!"Throws on error") {
+            watch_shader(shader_view<Vertex, Capabilities>(_shader), _vertexPath, _fragmentPath, std::move(_onReload), std::move(_transform));
+        }
+
+        // Swaps in every asset reloaded since the last call. Returns how many were swapped.
+        std::size_t apply_pending() noexcept;
+
+    private:
+        using relink_function = std::function<void(std::string_view _vertex, std::string_view _fragment)>;
+
+        struct texture_watch {
+            texture_manager* manager;
+            std::string name;
+            unique_texture_array const* array;
+            std::optional<texture_array_index> layer;
+        };
+
+        struct shader_watch {
+            relink_function relink;
+            fs::path vertexPath;
+            fs::path fragmentPath;
+            std::function<void()> onReload;
+        };
+
+        struct pending_texture {
+            fs::path path;
+            texture pixels;
+        };
+
+        struct pending_shader {
+            std::size_t index;
+            std::string vertex;
+            std::string fragment;
+        };
+
+        void add_texture_watch(fs::path const& _path, texture_watch _watch) noexcept(!"Throws on error");
+
+        void add_shader_watch(relink_function _relink,
+                              fs::path const& _vertexPath,
+                              fs::path const& _fragmentPath,
+                              std::function<void()> _onReload) noexcept(!"Throws on error");
+
+        void run_worker() noexcept;
+        void reload(fs::path const& _path) noexcept;
+
+        void apply(pending_texture const& _pending) noexcept;
+        void apply(pending_shader const& _pending) noexcept;
+
+        file_watcher m_watcher;
+
+        // Guards the watches, which the worker reads, and the pending assets
+        std::mutex m_mutex;
+
+        std::unordered_map<std::string, std::vector<texture_watch>> m_textureWatches;
+        std::vector<shader_watch> m_shaderWatches;
+        std::unordered_map<std::string, std::vector<std::size_t>> m_shaderIndices;
+
+        std::vector<pending_texture> m_pendingTextures;
+        std::vector<pending_shader> m_pendingShaders;
+
+        std::atomic<bool> m_stopping{false};
+        std::thread m_worker;
+    };
+#else
+    class hot_reloader {
+    public:
+        static auto constexpr enabled = false;
+
+        using source_transform = std::function<std::string(std::string_view _source)>;
+
+        void watch_texture(texture_manager&, fs::path const&) noexcept {}
+        void watch_texture(texture_manager&, fs::path const&, unique_texture_array const&, texture_array_index) noexcept {}
+
+        template<typename Shader>
+        void watch_shader(Shader const&, fs::path const&, fs::path const&, std::function<void()> = {}, source_transform = {}) noexcept {}
+
+        std::size_t apply_pending() noexcept { return 0; }
+    };
+#endif
+}    // namespace randomcat::engine::graphics::textures
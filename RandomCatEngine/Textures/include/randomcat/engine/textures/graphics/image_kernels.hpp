@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Bulk pixel operations on 8-bit RGBA (and RGB) images. Every kernel has a scalar
+// implementation and, on x86, SSSE3 and AVX2 implementations selected at runtime for
+// the running CPU. Passing an explicit isa forces a particular implementation, falling
+// back to the best supported one below it; this exists for benchmarks and testing.
+//
+// Unless otherwise noted, source and destination may not overlap.
+
+namespace randomcat::engine::graphics::textures::image_kernels {
+    using pixel_value = unsigned char;
+
+    enum class isa { scalar, ssse3, avx2 };
+
+    // The best implementation supported by the running CPU
+    [[nodiscard]] isa best_isa() noexcept;
+
+    // Order of channels to read from the source for each destination channel; e.g.
+    // {2, 1, 0, 3} converts BGRA to RGBA.
+    using channel_order = std::array<std::uint8_t, 4>;
+
+    void fill_rgba(pixel_value* _target, std::size_t _pixelCount, std::array<pixel_value, 4> _color, isa _isa = best_isa()) noexcept;
+
+    // Converts packed RGB pixels to RGBA with the given alpha
+    void expand_rgb_to_rgba(pixel_value* _target,
+                            pixel_value const* _source,
+                            std::size_t _pixelCount,
+                            pixel_value _alpha = 255,
+                            isa _isa = best_isa()) noexcept;
+
+    // Multiplies color channels by alpha, in place, rounding to nearest
+    void premultiply_alpha(pixel_value* _pixels, std::size_t _pixelCount, isa _isa = best_isa()) noexcept;
+
+    // _target may equal _source
+    void swizzle_rgba(pixel_value* _target, pixel_value const* _source, std::size_t _pixelCount, channel_order _order, isa _isa = best_isa()) noexcept;
+
+    // Converts color channels between sRGB and linear encodings, in place. Alpha is
+    // unchanged. These are table lookups and have no vectorized implementation.
+    void srgb_to_linear(pixel_value* _pixels, std::size_t _pixelCount) noexcept;
+    void linear_to_srgb(pixel_value* _pixels, std::size_t _pixelCount) noexcept;
+
+    // Box-filters an RGBA image to half size in each dimension (rounded down, minimum 1).
+    // An odd last row or column is dropped, and a dimension of 1 stays 1.
+    void downsample_rgba_2x(pixel_value* _target,
+                            pixel_value const* _source,
+                            std::int32_t _sourceWidth,
+                            std::int32_t _sourceHeight,
+                            isa _isa = best_isa()) noexcept;
+
+    [[nodiscard]] constexpr std::int32_t downsampled_dimension(std::int32_t _dimension) noexcept { return _dimension > 1 ? _dimension / 2 : 1; }
+}    // namespace randomcat::engine::graphics::textures::image_kernels
@@ -1,22 +1,58 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "randomcat/engine/low_level/detail/impl_only_access.hpp"
 
 namespace randomcat::engine::graphics::textures {
+    namespace texture_detail {
+        using image_value = unsigned char;
+
+        // Defined with the stbi implementation so that this header does not need it
+        void free_stbi_image(image_value* _data) noexcept;
+    }    // namespace texture_detail
+
+    // A non-owning reference to RGBA pixels. The pixels must outlive the view.
+    class texture_view {
+    public:
+        using public_image_value = texture_detail::image_value const;
+        using public_image_ptr = std::add_pointer_t<public_image_value>;
+
+        using dimension_t = std::int32_t;
+
+        static auto constexpr channels = 4;
+
+        explicit texture_view(dimension_t _width, dimension_t _height, public_image_ptr _data) noexcept
+        : m_width(_width), m_height(_height), m_data(_data) {}
+
+        [[nodiscard]] auto width() const noexcept { return m_width; }
+        [[nodiscard]] auto height() const noexcept { return m_height; }
+        [[nodiscard]] public_image_ptr data(impl_call_only) const noexcept { return m_data; }
+
+        [[nodiscard]] std::size_t size_bytes() const noexcept { return std::size_t(m_width) * std::size_t(m_height) * channels; }
+
+    private:
+        dimension_t m_width;
+        dimension_t m_height;
+        public_image_ptr m_data;
+    };
+
+    // Owns (or shares ownership of) RGBA pixels through a single reference-counted
+    // pointer. Copying a texture never copies its pixels.
     class texture {
     public:
-        using private_image_value = unsigned char;
-        using public_image_value = unsigned char const;
+        using private_image_value = texture_detail::image_value;
+        using public_image_value = private_image_value const;
 
         using private_image_ptr = std::add_pointer_t<private_image_value>;
         using public_image_ptr = std::add_pointer_t<public_image_value>;
 
-        using dimension_t = std::int32_t;
+        using dimension_t = texture_view::dimension_t;
 
-        static auto constexpr channels = 4;
+        static auto constexpr channels = texture_view::channels;
 
         struct stbi_memory_tag {};
         static auto constexpr stbi_memory = stbi_memory_tag{};
@@ -27,76 +63,48 @@ namespace randomcat::engine::graphics::textures {
         struct take_ownership_tag {};
         static auto constexpr take_ownership = take_ownership_tag{};
 
+        struct shared_memory_tag {};
+        static auto constexpr shared_memory = shared_memory_tag{};
+
         explicit texture(impl_call_only, dimension_t _width, dimension_t _height, stbi_memory_tag, private_image_ptr _data) noexcept
-        : texture(_width, _height, std::make_unique<stbi_underlying>(_data)) {}
+        : texture(_width, _height, std::shared_ptr<private_image_value>(_data, texture_detail::free_stbi_image)) {}
 
-        explicit texture(impl_call_only, dimension_t _width, dimension_t _height, copy_memory_tag, private_image_ptr _data) noexcept
-        : texture(_width, _height, std::make_unique<copy_memory_underlying>(_data, _width * _height * channels)) {}
+        explicit texture(impl_call_only, dimension_t _width, dimension_t _height, copy_memory_tag, public_image_ptr _data) noexcept
+        : texture(_width, _height, copy_pixels(_data, std::size_t(_width) * std::size_t(_height) * channels)) {}
 
         explicit texture(impl_call_only, dimension_t _width, dimension_t _height, take_ownership_tag, std::unique_ptr<private_image_value[]> _data) noexcept
-        : texture(_width, _height, std::make_unique<take_ownership_underlying>(std::move(_data))) {}
+        : texture(_width, _height, std::shared_ptr<private_image_value>(_data.release(), std::default_delete<private_image_value[]>())) {}
+
+        // Does not copy; _data must remain valid for as long as _owner is alive
+        explicit texture(impl_call_only, dimension_t _width, dimension_t _height, shared_memory_tag, std::shared_ptr<void const> const& _owner, private_image_ptr _data) noexcept
+        : texture(_width, _height, std::shared_ptr<private_image_value>(_owner, _data)) {}
 
         [[nodiscard]] auto width() const noexcept { return m_width; }
         [[nodiscard]] auto height() const noexcept { return m_height; }
-        [[nodiscard]] public_image_ptr data(impl_call_only) const noexcept { return m_data; }
-
-    private:
-        struct underlying;
-
-        explicit texture(std::int32_t _width, std::int32_t _height, std::unique_ptr<underlying> _underlying)
-        : m_width{std::move(_width)}, m_height{std::move(_height)}, m_underlying{std::move(_underlying)}, m_data(m_underlying->data()) {}
-
-        struct underlying {
-            underlying() noexcept = default;
-
-            underlying(underlying const&) = delete;
-            underlying(underlying&&) = delete;
-            underlying& operator=(underlying const&) = delete;
-            underlying& operator=(underlying&&) = delete;
+        [[nodiscard]] public_image_ptr data(impl_call_only) const noexcept { return m_data.get(); }
 
-            virtual ~underlying() noexcept = default;
-            virtual private_image_ptr data() const noexcept = 0;
-        };
+        [[nodiscard]] texture_view view() const noexcept { return texture_view(m_width, m_height, m_data.get()); }
+        /* implicit */ operator texture_view() const noexcept { return view(); }
 
-        struct stbi_underlying : underlying {
-        public:
-            stbi_underlying(private_image_ptr _stbiPtr) noexcept : m_stbiPtr(_stbiPtr) {}
-            virtual ~stbi_underlying() noexcept override;
-
-            virtual private_image_ptr data() const noexcept override { return m_stbiPtr; }
-
-        private:
-            private_image_ptr m_stbiPtr;
-        };
-
-        struct copy_memory_underlying : underlying {
-        public:
-            copy_memory_underlying(private_image_ptr _data, std::int32_t _length)
-            : m_data(std::make_unique<private_image_value[]>(_length)) {
-                std::copy(_data, _data + _length, m_data.get());
-            }
-            virtual ~copy_memory_underlying() noexcept override = default;
-
-            virtual private_image_ptr data() const noexcept override { return m_data.get(); }
-
-        private:
-            std::unique_ptr<private_image_value[]> m_data;
-        };
-
-        struct take_ownership_underlying : underlying {
-        public:
-            take_ownership_underlying(std::unique_ptr<private_image_value[]> _data) : m_data(std::move(_data)) {}
-            virtual ~take_ownership_underlying() noexcept override = default;
-
-            virtual private_image_ptr data() const noexcept override { return m_data.get(); }
+    private:
+        explicit texture(dimension_t _width, dimension_t _height, std::shared_ptr<private_image_value> _data) noexcept
+        : m_width{std::move(_width)}, m_height{std::move(_height)}, m_data{std::move(_data)} {}
 
-        private:
-            std::unique_ptr<private_image_value[]> m_data;
-        };
+        [[nodiscard]] static std::shared_ptr<private_image_value> copy_pixels(public_image_ptr _data, std::size_t _length) noexcept {
+            auto result = std::shared_ptr<private_image_value>(new private_image_value[_length], std::default_delete<private_image_value[]>());
+            std::copy(_data, _data + _length, result.get());
+            return result;
+        }
 
         dimension_t m_width;
         dimension_t m_height;
-        std::shared_ptr<underlying> m_underlying;
-        private_image_ptr m_data;
+        std::shared_ptr<private_image_value> m_data;
     };
+
+    namespace texture_detail {
+        // Lets generic builders accept textures, views and reference_wrappers to textures alike
+        [[nodiscard]] inline texture_view as_view(texture_view _view) noexcept { return _view; }
+        [[nodiscard]] inline texture_view as_view(texture const& _texture) noexcept { return _texture.view(); }
+        [[nodiscard]] inline texture_view as_view(std::reference_wrapper<texture const> _texture) noexcept { return _texture.get().view(); }
+    }    // namespace texture_detail
 }    // namespace randomcat::engine::graphics::textures
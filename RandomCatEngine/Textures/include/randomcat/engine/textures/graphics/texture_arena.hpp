@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "randomcat/engine/low_level/detail/impl_only_access.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    // Bump-allocates texel storage for many textures out of a few large blocks. Each
+    // texture made by the arena shares ownership of the block it lives in, so a block
+    // is freed once the arena and every texture in it are gone. Not thread-safe.
+    class texture_arena {
+    public:
+        using private_image_value = texture::private_image_value;
+        using private_image_ptr = texture::private_image_ptr;
+        using dimension_t = texture::dimension_t;
+
+        // Every texture in the arena starts on a boundary of this many bytes
+        static auto constexpr alignment = std::size_t(64);
+
+        explicit texture_arena(std::size_t _blockSize = std::size_t(16) * 1024 * 1024) noexcept : m_blockSize(_blockSize) {}
+
+        // Calls _fill with a pointer to uninitialized storage for _width * _height RGBA
+        // pixels, which it must fill, then returns a texture referring to that storage.
+        template<typename Fill>
+        [[nodiscard]] texture make_texture(dimension_t _width, dimension_t _height, Fill&& _fill) noexcept(!"Allocates") {
+            auto const data = allocate(std::size_t(_width) * std::size_t(_height) * texture::channels);
+            std::forward<Fill>(_fill)(data);
+            return texture{impl_call, _width, _height, texture::shared_memory, m_block, data};
+        }
+
+        [[nodiscard]] texture copy_texture(texture_view _source) noexcept(!"Allocates");
+
+        // Bytes handed out from the current block
+        [[nodiscard]] auto used_bytes() const noexcept { return m_used; }
+        [[nodiscard]] auto block_size() const noexcept { return m_blockSize; }
+
+    private:
+        [[nodiscard]] private_image_ptr allocate(std::size_t _bytes) noexcept(!"Allocates");
+
+        std::size_t m_blockSize;
+        std::shared_ptr<private_image_value> m_block;
+        std::size_t m_blockCapacity = 0;
+        std::size_t m_used = 0;
+    };
+}    // namespace randomcat::engine::graphics::textures
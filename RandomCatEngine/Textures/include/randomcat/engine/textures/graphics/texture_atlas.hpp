@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/impl_only_access.hpp"
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+#include "randomcat/engine/textures/graphics/texture_sections.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    namespace texture_atlas_detail {
+        struct texture_atlas_error_tag {};
+    }    // namespace texture_atlas_detail
+
+    using texture_atlas_error = util_detail::tag_exception<texture_atlas_detail::texture_atlas_error_tag>;
+
+    // The location of an image within an atlas. x, y, width and height describe the
+    // image itself, not including the padding around it.
+    struct texture_atlas_placement {
+        texture_array_index layer;
+        texture::dimension_t x;
+        texture::dimension_t y;
+        texture::dimension_t width;
+        texture::dimension_t height;
+    };
+
+    // Packs rectangles into as few fixed-size layers as possible using a bottom-left
+    // skyline heuristic. Every rectangle is surrounded by _padding pixels on each side,
+    // which are reserved so that the image edges can be extruded into them.
+    class texture_atlas_packer {
+    public:
+        using dimension_t = texture::dimension_t;
+
+        explicit texture_atlas_packer(dimension_t _layerWidth, dimension_t _layerHeight, dimension_t _padding = 1) noexcept
+        : m_layerWidth(_layerWidth), m_layerHeight(_layerHeight), m_padding(_padding) {}
+
+        // Throws texture_atlas_error if the rectangle is empty, or (with padding) is larger
+        // than a layer
+        [[nodiscard]] texture_atlas_placement pack(dimension_t _width, dimension_t _height) noexcept(!"Throws on error");
+
+        [[nodiscard]] auto layer_width() const noexcept { return m_layerWidth; }
+        [[nodiscard]] auto layer_height() const noexcept { return m_layerHeight; }
+        [[nodiscard]] auto padding() const noexcept { return m_padding; }
+
+        [[nodiscard]] GLsizei layer_count() const noexcept { return static_cast<GLsizei>(m_layers.size()); }
+
+        // Pixels covered by packed rectangles, including their padding
+        [[nodiscard]] auto used_area() const noexcept { return m_usedArea; }
+
+    private:
+        struct skyline_node {
+            dimension_t x;
+            dimension_t y;
+            dimension_t width;
+        };
+
+        using skyline = std::vector<skyline_node>;
+
+        struct skyline_fit {
+            std::size_t nodeIndex;
+            dimension_t y;
+        };
+
+        [[nodiscard]] bool find_fit(skyline const& _skyline, dimension_t _width, dimension_t _height, skyline_fit& _fit) const noexcept;
+        void place(skyline& _skyline, skyline_fit _fit, dimension_t _width, dimension_t _height) noexcept(!"Allocates");
+
+        dimension_t m_layerWidth;
+        dimension_t m_layerHeight;
+        dimension_t m_padding;
+
+        std::vector<skyline> m_layers;
+        std::int64_t m_usedArea = 0;
+    };
+
+    namespace texture_atlas_detail {
+        // Writes _texture into _staging, surrounded by _padding pixels that repeat the
+        // nearest edge pixel so that linear filtering does not bleed neighbouring images
+        void fill_padded_image(texture_view _texture, texture::dimension_t _padding, std::vector<texture::private_image_value>& _staging) noexcept(
+            !"Allocates");
+
+        template<bool TextureIsShared>
+        texture_rectangle bind_atlas_region(basic_texture_array<TextureIsShared, /*IsMutable=*/true> const& _array,
+                                            texture_atlas_placement const& _placement,
+                                            texture_view _texture,
+                                            texture::dimension_t _padding,
+                                            std::vector<texture::private_image_value>& _staging) noexcept(!"Allocates") {
+            fill_padded_image(_texture, _padding, _staging);
+
+            auto const textureArrayWidth = _array.width(impl_call);
+            auto const textureArrayHeight = _array.height(impl_call);
+
+            auto scope = gpu_scope("texture upload");
+            glBindTexture(GL_TEXTURE_2D_ARRAY, _array.raw_id(impl_call).value);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                            0,
+                            _placement.x - _padding,
+                            _placement.y - _padding,
+                            _placement.layer.value,
+                            _placement.width + 2 * _padding,
+                            _placement.height + 2 * _padding,
+                            1,
+                            GL_RGBA,
+                            GL_UNSIGNED_BYTE,
+                            _staging.data());
+            render_stats_detail::count_texture_upload(_staging.size());
+
+            return texture_rectangle{_placement.layer,
+                                     texture_rectangle::from_corner_and_dimensions,
+                                     {float(_placement.x) / float(textureArrayWidth), float(_placement.y) / float(textureArrayHeight)},
+                                     float(_placement.width) / float(textureArrayWidth),
+                                     float(_placement.height) / float(textureArrayHeight)};
+        }
+    }    // namespace texture_atlas_detail
+
+    // Packs every texture in [_begin, _end) into shared layers of a new texture array.
+    // Dereferencing an iterator must yield a texture, a texture_view or a reference to a texture.
+    // The returned rectangles are in the same order as the input textures.
+    template<typename InputIt>
+    [[nodiscard]] std::pair<unique_texture_array, std::vector<texture_rectangle>> make_texture_atlas(InputIt _begin,
+                                                                                                    InputIt _end,
+                                                                                                    GLsizei _layerWidth = 1024,
+                                                                                                    GLsizei _layerHeight = 1024,
+                                                                                                    GLsizei _padding = 1) noexcept(!"Throws on error") {
+        std::vector<texture_view> textures;
+        std::for_each(_begin, _end, [&](auto const& _texture) { textures.push_back(texture_detail::as_view(_texture)); });
+
+        // Packing tallest first keeps the skyline flat and wastes less space
+        std::vector<std::size_t> packOrder(textures.size());
+        std::iota(begin(packOrder), end(packOrder), std::size_t(0));
+        std::stable_sort(begin(packOrder), end(packOrder), [&](std::size_t _first, std::size_t _second) {
+            return textures[_first].height() > textures[_second].height();
+        });
+
+        auto packer = texture_atlas_packer(_layerWidth, _layerHeight, _padding);
+        std::vector<texture_atlas_placement> placements(textures.size());
+
+        for (auto index : packOrder) {
+            auto const& current = textures[index];
+            placements[index] = packer.pack(current.width(), current.height());
+        }
+
+        auto array = make_texture_array(_layerWidth, _layerHeight, std::max(packer.layer_count(), GLsizei(1)));
+
+        std::vector<texture::private_image_value> staging;
+        std::vector<texture_rectangle> rectangles;
+        rectangles.reserve(textures.size());
+
+        for (std::size_t i = 0; i < textures.size(); ++i) {
+            rectangles.push_back(texture_atlas_detail::bind_atlas_region(array, placements[i], textures[i], _padding, staging));
+        }
+
+        return {std::move(array), std::move(rectangles)};
+    }
+
+    template<typename Range>
+    [[nodiscard]] decltype(auto) make_texture_atlas(Range const& _range,
+                                                    GLsizei _layerWidth = 1024,
+                                                    GLsizei _layerHeight = 1024,
+                                                    GLsizei _padding = 1) noexcept(!"Throws on error") {
+        using std::begin, std::end;
+        return make_texture_atlas(begin(_range), end(_range), _layerWidth, _layerHeight, _padding);
+    }
+}    // namespace randomcat::engine::graphics::textures
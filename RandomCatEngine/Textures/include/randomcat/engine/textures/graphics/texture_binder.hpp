@@ -1,11 +1,23 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
+#include <string>
+#include <tuple>
 #include <utility>
+#include <vector>
 
 #include <GL/glew.h>
 
 #include "randomcat/engine/low_level/detail/impl_only_access.hpp"
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
 #include "randomcat/engine/low_level/graphics/gl_wrappers/texture_raii.hpp"
+#include "randomcat/engine/low_level/graphics/gpu_profiler.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
 #include "randomcat/engine/textures/graphics/texture_manager.hpp"
 #include "randomcat/engine/textures/graphics/texture_sections.hpp"
 
@@ -28,13 +40,21 @@ namespace randomcat::engine::graphics::textures {
 
         template<bool Enable = is_shared, typename = std::enable_if_t<Enable>>
         /* implicit */ basic_texture_array(as_unique&& _other)
-        : m_id(std::move(_other.m_id)), m_width(std::move(_other.m_width)), m_height(std::move(_other.m_height)), m_layers(std::move(_other.m_layers)) {}
+        : m_id(std::move(_other.m_id)),
+          m_width(std::move(_other.m_width)),
+          m_height(std::move(_other.m_height)),
+          m_layers(std::move(_other.m_layers)),
+          m_levels(std::move(_other.m_levels)) {}
 
         // Enable must be a parameter type to prevent error for copy constructor not
         // taking reference arg
         template<bool Enable = is_const>
         /* implicit */ basic_texture_array(std::enable_if_t<Enable, as_mutable> _other)
-        : m_id(std::move(_other.m_id)), m_width(std::move(_other.m_width)), m_height(std::move(_other.m_height)), m_layers(std::move(_other.m_layers)) {}
+        : m_id(std::move(_other.m_id)),
+          m_width(std::move(_other.m_width)),
+          m_height(std::move(_other.m_height)),
+          m_layers(std::move(_other.m_layers)),
+          m_levels(std::move(_other.m_levels)) {}
 
         auto width(impl_call_only) const noexcept { return m_width; }
 
@@ -42,23 +62,29 @@ namespace randomcat::engine::graphics::textures {
 
         auto layers(impl_call_only) const noexcept { return m_layers; }
 
+        // Number of mipmap levels, including the base level
+        auto levels(impl_call_only) const noexcept { return m_levels; }
+
         auto raw_id(impl_call_only) const noexcept { return typename id_type::raw_id(m_id); }
 
     private:
         using id_type = std::conditional_t<Shared, gl_detail::shared_texture_id, gl_detail::unique_texture_id>;
 
-        explicit basic_texture_array(id_type _id, GLsizei _width, GLsizei _height, GLsizei _layers)
-        : m_id(std::move(_id)), m_width(std::move(_width)), m_height(std::move(_height)), m_layers(std::move(_layers)) {}
+        explicit basic_texture_array(id_type _id, GLsizei _width, GLsizei _height, GLsizei _layers, GLsizei _levels)
+        : m_id(std::move(_id)), m_width(std::move(_width)), m_height(std::move(_height)), m_layers(std::move(_layers)), m_levels(std::move(_levels)) {}
 
         id_type m_id;
         GLsizei m_width;
         GLsizei m_height;
         GLsizei m_layers;
+        GLsizei m_levels;
 
         template<bool, bool>
         friend class basic_texture_array;
 
         friend basic_texture_array<false, true> make_texture_array(int _width, int _height, int _layers) noexcept;
+        friend basic_texture_array<false, true> make_mipmapped_texture_array(int _width, int _height, int _layers) noexcept;
+        friend basic_texture_array<false, true> make_sparse_texture_array(int _width, int _height, int _layers) noexcept;
     };
 
     using unique_texture_array = basic_texture_array</*Shared=*/false, true>;
@@ -66,26 +92,64 @@ namespace randomcat::engine::graphics::textures {
     using const_unique_texture_array = unique_texture_array::as_const;
     using const_shared_texture_array = shared_texture_array::as_const;
 
-    [[nodiscard]] unique_texture_array make_texture_array(GLsizei _width, GLsizei _height, GLsizei _layers) noexcept {
+    [[nodiscard]] inline unique_texture_array make_texture_array(GLsizei _width, GLsizei _height, GLsizei _layers) noexcept {
         gl_detail::unique_texture_id id;
         glBindTexture(GL_TEXTURE_2D_ARRAY, id.value());
         glTexStorage3D(GL_TEXTURE_2D_ARRAY, 1, GL_RGBA8, _width, _height, _layers);
 
-        return unique_texture_array{std::move(id), _width, _height, _layers};
+        return unique_texture_array{std::move(id), _width, _height, _layers, 1};
+    }
+
+    namespace texture_array_detail {
+        [[nodiscard]] inline GLsizei full_mip_chain_levels(GLsizei _width, GLsizei _height) noexcept {
+            auto levels = GLsizei(1);
+            while ((std::max(_width, _height) >> levels) > 0) ++levels;
+            return levels;
+        }
+    }    // namespace texture_array_detail
+
+    // As make_texture_array, but with storage for a full mipmap chain. Layers should be
+    // bound with bind_texture_array_layer_mipmapped.
+    [[nodiscard]] inline unique_texture_array make_mipmapped_texture_array(GLsizei _width, GLsizei _height, GLsizei _layers) noexcept {
+        auto const levels = texture_array_detail::full_mip_chain_levels(_width, _height);
+
+        gl_detail::unique_texture_id id;
+        glBindTexture(GL_TEXTURE_2D_ARRAY, id.value());
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, _width, _height, _layers);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+        return unique_texture_array{std::move(id), _width, _height, _layers, levels};
+    }
+
+    // As make_mipmapped_texture_array, but using GL_ARB_sparse_texture so that no memory
+    // is committed until glTexPageCommitmentARB is called. The caller must check that the
+    // extension is present and that the dimensions are multiples of the page size.
+    [[nodiscard]] inline unique_texture_array make_sparse_texture_array(GLsizei _width, GLsizei _height, GLsizei _layers) noexcept {
+        auto const levels = texture_array_detail::full_mip_chain_levels(_width, _height);
+
+        gl_detail::unique_texture_id id;
+        glBindTexture(GL_TEXTURE_2D_ARRAY, id.value());
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, GL_RGBA8, _width, _height, _layers);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+        return unique_texture_array{std::move(id), _width, _height, _layers, levels};
     }
 
     template<bool TextureIsShared>
     texture_rectangle bind_texture_array_layer(basic_texture_array<TextureIsShared, /*IsMutable=*/true> const& _array,
                                                texture_array_index _layerNum,
-                                               texture const& _texture) noexcept {
+                                               texture_view _texture) noexcept {
         auto const imageWidth = _texture.width();
         auto const imageHeight = _texture.height();
 
         auto const textureArrayWidth = _array.width(impl_call);
         auto const textureArrayHeight = _array.height(impl_call);
 
+        auto scope = gpu_scope("texture upload");
         glBindTexture(GL_TEXTURE_2D_ARRAY, _array.raw_id(impl_call).value);
         glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, _layerNum.value, imageWidth, imageHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, _texture.data(impl_call));
+        render_stats_detail::count_texture_upload(std::size_t(imageWidth) * std::size_t(imageHeight) * texture::channels);
 
         return texture_rectangle{_layerNum,
                                  texture_rectangle::from_corner_and_dimensions,
@@ -94,6 +158,161 @@ namespace randomcat::engine::graphics::textures {
                                  float(imageHeight) / float(textureArrayHeight)};
     }
 
+    namespace texture_array_detail {
+        struct texture_array_error_tag {};
+
+        // Upper bound on the staging memory used to upload several layers with one call
+        inline auto constexpr max_batch_upload_bytes = std::size_t(16) * 1024 * 1024;
+
+        template<bool TextureIsShared>
+        void upload_texture_array_layers(basic_texture_array<TextureIsShared, /*IsMutable=*/true> const& _array,
+                                         texture_array_index _firstLayer,
+                                         GLsizei _layerCount,
+                                         texture::public_image_ptr _data) noexcept {
+            auto scope = gpu_scope("texture upload");
+            glBindTexture(GL_TEXTURE_2D_ARRAY, _array.raw_id(impl_call).value);
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                            0,
+                            0,
+                            0,
+                            _firstLayer.value,
+                            _array.width(impl_call),
+                            _array.height(impl_call),
+                            _layerCount,
+                            GL_RGBA,
+                            GL_UNSIGNED_BYTE,
+                            _data);
+            render_stats_detail::count_texture_upload(std::size_t(_array.width(impl_call)) * std::size_t(_array.height(impl_call))
+                                                      * std::size_t(_layerCount) * texture::channels);
+        }
+    }    // namespace texture_array_detail
+
+    using texture_array_error = util_detail::tag_exception<texture_array_detail::texture_array_error_tag>;
+
+    // Builds a texture array with one layer per texture in [_begin, _end). Dereferencing
+    // an iterator must yield a texture, a texture_view or a reference to a texture. Storage is
+    // allocated once, sized to the largest texture, and runs of full-size textures are
+    // uploaded together. The returned rectangles are in the same order as the input.
+    template<typename InputIt>
+    [[nodiscard]] std::pair<unique_texture_array, std::vector<texture_rectangle>> make_texture_array_from_range(InputIt _begin,
+                                                                                                               InputIt _end) noexcept(!"Allocates") {
+        std::vector<texture_view> textures;
+        std::for_each(_begin, _end, [&](auto const& _texture) { textures.push_back(texture_detail::as_view(_texture)); });
+
+        auto width = GLsizei(1);
+        auto height = GLsizei(1);
+
+        for (auto const& current : textures) {
+            width = std::max(width, current.width());
+            height = std::max(height, current.height());
+        }
+
+        auto const layers = std::max(GLsizei(textures.size()), GLsizei(1));
+        auto array = make_texture_array(width, height, layers);
+
+        auto const layerBytes = std::size_t(width) * std::size_t(height) * texture::channels;
+        auto const batchLayers = std::max(texture_array_detail::max_batch_upload_bytes / layerBytes, std::size_t(1));
+
+        std::vector<texture::private_image_value> staging;
+        auto batchStart = GLint(0);
+        auto batchCount = GLsizei(0);
+
+        auto const flushBatch = [&] {
+            if (batchCount == 0) return;
+            texture_array_detail::upload_texture_array_layers(array, {batchStart}, batchCount, staging.data());
+            batchCount = 0;
+        };
+
+        std::vector<texture_rectangle> rectangles;
+        rectangles.reserve(textures.size());
+
+        for (std::size_t i = 0; i < textures.size(); ++i) {
+            auto const& current = textures[i];
+            auto const layer = texture_array_index{GLint(i)};
+
+            if (batchLayers == 1 || current.width() != width || current.height() != height) {
+                flushBatch();
+                rectangles.push_back(bind_texture_array_layer(array, layer, current));
+                continue;
+            }
+
+            if (batchCount == 0) {
+                batchStart = layer.value;
+                staging.resize(std::min(batchLayers, textures.size() - i) * layerBytes);
+            }
+
+            auto const source = current.data(impl_call);
+            std::copy(source, source + layerBytes, staging.data() + std::size_t(batchCount) * layerBytes);
+            ++batchCount;
+
+            if (std::size_t(batchCount) == batchLayers) flushBatch();
+
+            rectangles.push_back(texture_rectangle{layer, texture_rectangle::from_corner_and_dimensions, {0, 0}, 1.0f, 1.0f});
+        }
+
+        flushBatch();
+
+        return {std::move(array), std::move(rectangles)};
+    }
+
+    template<typename Range>
+    [[nodiscard]] decltype(auto) make_texture_array_from_range(Range const& _range) noexcept(!"Allocates") {
+        using std::begin, std::end;
+        return make_texture_array_from_range(begin(_range), end(_range));
+    }
+
+    // Builds a texture array of the given layer size from textures that are still being
+    // decoded, uploading each one as soon as its future becomes ready rather than in
+    // order. Layer i always holds the result of _futures[i]. Works with std::future and
+    // std::shared_future; rethrows any exception stored in a future.
+    // Throws texture_array_error if a texture is larger than the layer size.
+    template<typename Future>
+    [[nodiscard]] std::pair<unique_texture_array, std::vector<texture_rectangle>> make_texture_array_from_futures(std::vector<Future>& _futures,
+                                                                                                                 GLsizei _width,
+                                                                                                                 GLsizei _height) noexcept(!"Throws on error") {
+        using namespace std::chrono_literals;
+
+        auto array = make_texture_array(_width, _height, std::max(GLsizei(_futures.size()), GLsizei(1)));
+
+        std::vector<std::optional<texture_rectangle>> rectangles(_futures.size());
+        auto remaining = _futures.size();
+
+        auto const uploadLayer = [&](std::size_t _index) {
+            auto const& current = _futures[_index].get();
+
+            if (current.width() > _width || current.height() > _height) {
+                throw texture_array_error{"Texture of size " + std::to_string(current.width()) + "x" + std::to_string(current.height())
+                                          + " does not fit in texture array of size " + std::to_string(_width) + "x" + std::to_string(_height)};
+            }
+
+            rectangles[_index] = bind_texture_array_layer(array, {GLint(_index)}, current);
+            --remaining;
+        };
+
+        while (remaining > 0) {
+            auto uploadedAny = false;
+
+            for (std::size_t i = 0; i < _futures.size(); ++i) {
+                if (!rectangles[i] && _futures[i].wait_for(0s) == std::future_status::ready) {
+                    uploadLayer(i);
+                    uploadedAny = true;
+                }
+            }
+
+            if (!uploadedAny) {
+                // Nothing is ready, so block on the first outstanding texture
+                auto const next = std::find_if(begin(rectangles), end(rectangles), [](auto const& _rect) { return !_rect; }) - begin(rectangles);
+                uploadLayer(next);
+            }
+        }
+
+        std::vector<texture_rectangle> result;
+        result.reserve(rectangles.size());
+        std::transform(begin(rectangles), end(rectangles), std::back_inserter(result), [](auto const& _rect) { return *_rect; });
+
+        return {std::move(array), std::move(result)};
+    }
+
     namespace texture_array_detail {
         template<typename To, typename... Ignored>
         using to_first = To;
@@ -104,17 +323,10 @@ namespace randomcat::engine::graphics::textures {
             Textures const&... _textures) noexcept {
             static_assert((std::is_same_v<Textures, textures::texture> && ...), "All arguments must be textures");
 
-            auto width = std::max({_textures.width()...});
-            auto height = std::max({_textures.height()...});
-            auto layers = sizeof...(Textures);
-            auto array = make_texture_array(width, height, layers);
-
-            return std::apply(
-                [&](auto... textureSections) {
-                    return std::tuple<unique_texture_array, texture_array_detail::to_first<texture_rectangle, Textures>...>{std::move(array),
-                                                                                                                            std::move(textureSections)...};
-                },
-                std::forward_as_tuple(bind_texture_array_layer(array, {Numbers}, _textures)...));
+            auto built = make_texture_array_from_range(std::array<texture_view, sizeof...(Textures)>{_textures.view()...});
+
+            return std::tuple<unique_texture_array, texture_array_detail::to_first<texture_rectangle, Textures>...>{std::move(built.first),
+                                                                                                                    built.second[Numbers]...};
         }
     }    // namespace texture_array_detail
 
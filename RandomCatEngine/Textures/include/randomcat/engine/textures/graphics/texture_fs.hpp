@@ -1,5 +1,8 @@
 #pragma once
 
+#include <future>
+#include <vector>
+
 #include <randomcat/util/require_filesystem.hpp>
 
 #include "randomcat/engine/textures/graphics/texture.hpp"
@@ -13,4 +16,8 @@ namespace randomcat::engine::graphics::textures {
 
     texture load_texture_file(fs::path const& _path) noexcept(!"Throws on error");
     texture const& load_texture_file(texture_manager& _textureManager, fs::path const& _path) noexcept(!"Throws on error");
+
+    // Decodes the files on a small pool of background threads. Each future rethrows
+    // texture_load_error from get() if its file could not be loaded.
+    [[nodiscard]] std::vector<std::future<texture>> load_texture_files_async(std::vector<fs::path> _paths) noexcept(!"Allocates");
 }    // namespace randomcat::engine::graphics::textures
@@ -31,6 +31,9 @@ namespace randomcat::engine::graphics::textures {
         // Copies the texture into the map, returns a reference to the new texture
         texture const& add_texture(std::string _newName, texture _texture) noexcept(!"Throws on error");
 
+        // Replaces the texture in place, so references to it see the new pixels
+        texture const& replace_texture(std::string_view _name, texture _texture) noexcept(!"Throws on error");
+
     private:
         using map_t = std::unordered_map<std::string, texture>;
         using map_iter_t = typename map_t::iterator;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/impl_only_access.hpp"
+#include "randomcat/engine/textures/graphics/image_kernels.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    // Box-filters _base down to 1x1, returning every level after the base
+    [[nodiscard]] std::vector<texture> make_texture_mip_chain(texture_view _base) noexcept(!"Allocates");
+
+    // Uploads _texture and its mip chain into one layer of a mipmapped texture array.
+    // Levels are generated on the CPU because glGenerateMipmap would regenerate every
+    // layer of the array.
+    template<bool TextureIsShared>
+    texture_rectangle bind_texture_array_layer_mipmapped(basic_texture_array<TextureIsShared, /*IsMutable=*/true> const& _array,
+                                                         texture_array_index _layerNum,
+                                                         texture_view _texture) noexcept(!"Allocates") {
+        auto const result = bind_texture_array_layer(_array, _layerNum, _texture);
+
+        std::vector<texture::private_image_value> current;
+        std::vector<texture::private_image_value> next;
+
+        auto width = _texture.width();
+        auto height = _texture.height();
+        auto source = _texture.data(impl_call);
+
+        for (GLint level = 1; level < _array.levels(impl_call) && (width > 1 || height > 1); ++level) {
+            auto const nextWidth = image_kernels::downsampled_dimension(width);
+            auto const nextHeight = image_kernels::downsampled_dimension(height);
+
+            next.resize(std::size_t(nextWidth) * std::size_t(nextHeight) * texture::channels);
+            image_kernels::downsample_rgba_2x(next.data(), source, width, height);
+
+            {
+                auto scope = gpu_scope("texture upload");
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, _layerNum.value, nextWidth, nextHeight, 1, GL_RGBA, GL_UNSIGNED_BYTE, next.data());
+                render_stats_detail::count_texture_upload(next.size());
+            }
+
+            std::swap(current, next);
+            source = current.data();
+            width = nextWidth;
+            height = nextHeight;
+        }
+
+        return result;
+    }
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <randomcat/util/require_filesystem.hpp>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_manager.hpp"
+
+// A texture pack is a single file holding pre-decoded RGBA texels for many textures,
+// preceded by an index of their names and sizes. Packs are written offline and
+// memory-mapped at runtime, so loading a texture from one neither decodes nor copies.
+// Packs use the native byte order of the machine that wrote them.
+
+namespace randomcat::engine::graphics::textures {
+    namespace texture_pack_detail {
+        struct texture_pack_error_tag {};
+    }    // namespace texture_pack_detail
+
+    using texture_pack_error = util_detail::tag_exception<texture_pack_detail::texture_pack_error_tag>;
+
+    class texture_pack_writer {
+    public:
+        // Textures are not copied; they must outlive the call to write
+        void add_texture(std::string _name, texture const& _texture) noexcept(!"Allocates");
+
+        void write(fs::path const& _path) const noexcept(!"Throws on error");
+
+    private:
+        struct pending_entry {
+            std::string name;
+            std::reference_wrapper<texture const> image;
+        };
+
+        std::vector<pending_entry> m_entries;
+    };
+
+    class texture_pack {
+    public:
+        // Maps the file and validates its index. Throws texture_pack_error if the file
+        // cannot be opened or is not a valid pack.
+        explicit texture_pack(fs::path const& _path) noexcept(!"Throws on error");
+
+        [[nodiscard]] bool has_texture(std::string_view _name) const noexcept;
+
+        // The returned texture points directly into the mapping and keeps it alive
+        [[nodiscard]] texture get_texture(std::string_view _name) const noexcept(!"Throws if texture not found");
+
+        // As get_texture, but the view does not keep the mapping alive; it is only valid
+        // for as long as this pack is
+        [[nodiscard]] texture_view view_texture(std::string_view _name) const noexcept(!"Throws if texture not found");
+
+        [[nodiscard]] std::vector<std::string_view> names() const noexcept(!"Allocates");
+
+        [[nodiscard]] auto size() const noexcept { return m_entries.size(); }
+
+        // Registers every texture in the pack with _manager under its packed name
+        void add_all_to(texture_manager& _manager) const noexcept(!"Throws on error");
+
+    private:
+        struct mapping;
+
+        struct entry {
+            std::string_view name;
+            texture::dimension_t width;
+            texture::dimension_t height;
+            texture::private_image_ptr data;
+        };
+
+        [[nodiscard]] entry const& find_entry(std::string_view _name) const noexcept(!"Throws if texture not found");
+        [[nodiscard]] texture make_texture(entry const& _entry) const noexcept;
+
+        std::shared_ptr<mapping> m_mapping;
+        std::vector<entry> m_entries;    // Sorted by name
+    };
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+#include "randomcat/engine/textures/graphics/texture_manager.hpp"
+#include "randomcat/engine/textures/graphics/texture_sections.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    namespace texture_residency_detail {
+        struct texture_residency_error_tag {};
+    }    // namespace texture_residency_detail
+
+    using texture_residency_error = util_detail::tag_exception<texture_residency_detail::texture_residency_error_tag>;
+
+    enum class cpu_copy_policy {
+        // Drop the pixels once uploaded; they are reloaded if the layer is evicted
+        drop_after_upload,
+        // Keep the pixels while within the CPU budget so re-uploads skip the loader
+        keep_within_budget,
+    };
+
+    struct texture_residency_stats {
+        std::size_t cpuBytes;
+        std::size_t gpuBytes;    // Whole layers, since that is what a resident texture occupies
+        std::int64_t loads;
+        std::int64_t uploads;
+        std::int64_t gpuEvictions;
+        std::int64_t cpuEvictions;
+    };
+
+    // Keeps a bounded working set of textures resident in the layers of one texture
+    // array. Textures are registered with a loader and only loaded and uploaded when
+    // acquired; when all layers are taken, the least recently acquired texture loses its
+    // layer. CPU copies of pixels are tracked against a separate budget.
+    //
+    // Rectangles returned by acquire are only valid until the next call to
+    // begin_frame, since after that the texture may be evicted. Textures acquired since
+    // the last begin_frame are never evicted.
+    class texture_residency {
+    public:
+        using loader = std::function<texture()>;
+
+        // The layer count is the GPU budget divided by the size of one layer
+        explicit texture_residency(GLsizei _layerWidth, GLsizei _layerHeight, std::size_t _gpuBudgetBytes, std::size_t _cpuBudgetBytes) noexcept(
+            !"Throws on error");
+
+        // Throws texture_duplicate_path_error if _name is already registered
+        void register_texture(std::string _name, loader _loader, cpu_copy_policy _policy = cpu_copy_policy::drop_after_upload) noexcept(
+            !"Throws on error");
+
+        // Evicts the texture if resident and forgets its loader. Returns whether it was registered.
+        bool unregister_texture(std::string_view _name) noexcept;
+
+        [[nodiscard]] bool is_registered(std::string_view _name) const noexcept;
+        [[nodiscard]] bool is_resident(std::string_view _name) const noexcept;
+
+        // Makes the texture resident, loading and uploading it if needed, and marks it used
+        // this frame. Throws no_such_texture_error if _name is not registered, and
+        // texture_residency_error if every layer is used this frame or the texture is
+        // larger than a layer.
+        [[nodiscard]] texture_rectangle acquire(std::string_view _name) noexcept(!"Throws on error");
+
+        void begin_frame() noexcept { ++m_frame; }
+
+        // Drops every CPU copy, e.g. when changing zones
+        void release_cpu_copies() noexcept;
+
+        [[nodiscard]] auto const& array() const noexcept { return m_array; }
+        [[nodiscard]] auto layer_count() const noexcept { return m_array.layers(impl_call); }
+        [[nodiscard]] auto const& stats() const noexcept { return m_stats; }
+
+    private:
+        struct entry {
+            explicit entry(std::string _name, loader _load, cpu_copy_policy _policy) noexcept
+            : name(std::move(_name)), load(std::move(_load)), policy(_policy) {}
+
+            std::string name;
+            loader load;
+            cpu_copy_policy policy;
+
+            std::optional<texture> cpuCopy;
+            std::list<entry*>::iterator cpuLruPosition;
+
+            std::optional<texture_array_index> layer;
+            std::optional<texture_rectangle> rectangle;
+            std::list<entry*>::iterator gpuLruPosition;
+
+            std::int64_t lastUsedFrame = -1;
+        };
+
+        [[nodiscard]] entry* find_entry(std::string_view _name) noexcept;
+        [[nodiscard]] entry const* find_entry(std::string_view _name) const noexcept;
+
+        [[nodiscard]] std::size_t layer_bytes() const noexcept;
+        [[nodiscard]] texture_array_index take_free_layer() noexcept(!"Throws on error");
+
+        void evict_gpu(entry& _entry) noexcept;
+        void drop_cpu_copy(entry& _entry) noexcept;
+        void store_cpu_copy(entry& _entry, texture _texture) noexcept(!"Allocates");
+
+        unique_texture_array m_array;
+        std::size_t m_cpuBudgetBytes;
+
+        // unordered_map does not move its nodes, so entries can be referred to by pointer
+        std::unordered_map<std::string, entry> m_entries;
+
+        // Front is most recently used
+        std::list<entry*> m_gpuLru;
+        std::list<entry*> m_cpuLru;
+
+        std::vector<texture_array_index> m_freeLayers;
+
+        std::int64_t m_frame = 0;
+        texture_residency_stats m_stats{};
+    };
+}    // namespace randomcat::engine::graphics::textures
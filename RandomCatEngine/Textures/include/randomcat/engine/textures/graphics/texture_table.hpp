@@ -0,0 +1,118 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+#include "randomcat/engine/low_level/graphics/gl_wrappers/buffer_raii.hpp"
+#include "randomcat/engine/low_level/graphics/gl_wrappers/texture_raii.hpp"
+#include "randomcat/engine/low_level/graphics/shader_uniforms.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+#include "randomcat/engine/textures/graphics/texture_sections.hpp"
+
+// A texture table gives every texture in a set a small integer index, which is stored
+// in the layer field of texture_rectangle (and so of vertices) exactly as array layers
+// are. Shaders sample through sample_texture_table(index, coord), which the table defines.
+//
+// With GL_ARB_bindless_texture, each texture keeps its own size and gets a resident
+// handle; the handles live in a uniform buffer indexed by the table index, so the vertex
+// format does not change and mixed texture sizes do not break batching. Without the
+// extension, the table falls back to a single texture array.
+
+namespace randomcat::engine::graphics::textures {
+    namespace texture_table_detail {
+        struct texture_table_error_tag {};
+        struct handle_buffer_tag {};
+    }    // namespace texture_table_detail
+
+    using texture_table_error = util_detail::tag_exception<texture_table_detail::texture_table_error_tag>;
+
+    enum class texture_table_mode {
+        automatic,    // Bindless if supported, otherwise array
+        bindless,     // Throws texture_table_error if unsupported
+        array,
+    };
+
+    class texture_table {
+    public:
+        // Handles are packed two per uvec4, and 16KiB is the smallest uniform block size GL allows
+        static auto constexpr max_bindless_textures = 2048;
+
+        static auto constexpr uniform_block_name = "rc_texture_table";
+        static auto constexpr array_sampler_name = "rc_texture_array";
+
+        explicit texture_table(std::vector<texture_view> const& _textures, texture_table_mode _mode = texture_table_mode::automatic) noexcept(
+            !"Throws on error");
+
+        texture_table(texture_table const&) = delete;
+        texture_table(texture_table&&) noexcept = default;
+
+        texture_table& operator=(texture_table const&) = delete;
+        texture_table& operator=(texture_table&&) = delete;
+
+        ~texture_table() noexcept;
+
+        [[nodiscard]] bool is_bindless() const noexcept { return !m_array.has_value(); }
+
+        // In the same order as the textures the table was made from
+        [[nodiscard]] auto const& rectangles() const noexcept { return m_rectangles; }
+
+        // Returns _source with the declarations of sample_texture_table inserted after its
+        // #version line, which must be the first line of _source apart from whitespace. For
+        // a bindless table, the version is raised to 400 if it is lower.
+        [[nodiscard]] std::string prepare_shader_source(std::string_view _source) const noexcept(!"Throws on error");
+
+        // Makes the table's textures available to the shader. Must be called again if
+        // another texture or uniform buffer is bound in between draws.
+        template<typename Capabilities>
+        void bind(shader_uniform_writer<Capabilities> const& _uniforms, GLuint _blockBinding = 0) const noexcept(!"Throws on error") {
+            if (is_bindless()) {
+                glBindBufferBase(GL_UNIFORM_BUFFER, _blockBinding, m_handleBuffer->value());
+                _uniforms.set_uniform_block_binding(uniform_block_name, _blockBinding);
+            } else {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D_ARRAY, m_array->raw_id(impl_call).value);
+                _uniforms.set_int(array_sampler_name, 0);
+            }
+        }
+
+        [[nodiscard]] static bool bindless_supported() noexcept;
+
+    private:
+        void make_bindless(std::vector<texture_view> const& _textures) noexcept(!"Throws on error");
+
+        std::vector<texture_rectangle> m_rectangles;
+
+        // Bindless mode
+        std::vector<gl_detail::unique_texture_id> m_textures;
+        std::vector<GLuint64> m_handles;
+        std::optional<gl_detail::unique_buffer_id<texture_table_detail::handle_buffer_tag>> m_handleBuffer;
+
+        // Array mode
+        std::optional<unique_texture_array> m_array;
+    };
+
+    // Dereferencing an iterator must yield a texture, a texture_view or a reference to a texture
+    template<typename InputIt>
+    [[nodiscard]] texture_table make_texture_table(InputIt _begin, InputIt _end, texture_table_mode _mode = texture_table_mode::automatic) noexcept(
+        !"Throws on error") {
+        std::vector<texture_view> textures;
+        std::for_each(_begin, _end, [&](auto const& _texture) { textures.push_back(texture_detail::as_view(_texture)); });
+
+        return texture_table(textures, _mode);
+    }
+
+    template<typename Range>
+    [[nodiscard]] texture_table make_texture_table(Range const& _range, texture_table_mode _mode = texture_table_mode::automatic) noexcept(
+        !"Throws on error") {
+        using std::begin, std::end;
+        return make_texture_table(begin(_range), end(_range), _mode);
+    }
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "randomcat/engine/low_level/detail/tag_exception.hpp"
+#include "randomcat/engine/low_level/graphics/gl_wrappers/buffer_raii.hpp"
+#include "randomcat/engine/low_level/graphics/gl_wrappers/texture_raii.hpp"
+#include "randomcat/engine/low_level/graphics/shader_uniforms.hpp"
+#include "randomcat/engine/textures/graphics/texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_array_index.hpp"
+#include "randomcat/engine/textures/graphics/texture_binder.hpp"
+#include "randomcat/engine/textures/graphics/texture_sections.hpp"
+
+// A virtual texture array has far more layers than are ever in memory at once. Vertices
+// use virtual layer indices as usual; each frame the game reports which layers (and how
+// fine a mip level) it drew, and update() loads what was reported and evicts the least
+// recently reported layers to stay within a byte budget. Newly reported layers become
+// visible from the next frame.
+//
+// With GL_ARB_sparse_texture, the array has every virtual layer but memory is only
+// committed for resident layers and mip levels. Otherwise a smaller physical array is
+// used, with a page table mapping virtual layers to physical ones. Either way, shaders
+// sample through sample_virtual_texture(layer, coord), which returns transparent black
+// for layers that are not resident.
+
+namespace randomcat::engine::graphics::textures {
+    namespace virtual_texture_detail {
+        struct virtual_texture_error_tag {};
+        struct page_table_buffer_tag {};
+    }    // namespace virtual_texture_detail
+
+    using virtual_texture_error = util_detail::tag_exception<virtual_texture_detail::virtual_texture_error_tag>;
+
+    enum class virtual_texture_backing { sparse, page_table };
+
+    class virtual_texture_array {
+    public:
+        // Must return a texture of exactly the layer size
+        using loader = std::function<texture(texture_array_index _layer)>;
+
+        static auto constexpr texture_sampler_name = "rc_virtual_texture";
+        static auto constexpr page_table_sampler_name = "rc_virtual_page_table";
+
+        // Uses sparse storage when supported unless _backing says otherwise. Throws
+        // virtual_texture_error if _budgetBytes cannot hold a single layer.
+        explicit virtual_texture_array(GLsizei _layerWidth,
+                                       GLsizei _layerHeight,
+                                       GLsizei _virtualLayers,
+                                       std::size_t _budgetBytes,
+                                       loader _loader,
+                                       std::optional<virtual_texture_backing> _backing = std::nullopt) noexcept(!"Throws on error");
+
+        // Feedback: _layer was drawn this frame, needing mip levels from _finestLevel down
+        void note_sampled(texture_array_index _layer, GLint _finestLevel = 0) noexcept;
+
+        // Call once per frame, after drawing. Loads noted layers and evicts others as needed.
+        void update() noexcept(!"Throws on error");
+
+        [[nodiscard]] bool is_resident(texture_array_index _layer) const noexcept;
+
+        [[nodiscard]] auto backing() const noexcept { return m_backing; }
+        [[nodiscard]] auto committed_bytes() const noexcept { return m_committedBytes; }
+        [[nodiscard]] auto budget_bytes() const noexcept { return m_budgetBytes; }
+        [[nodiscard]] auto virtual_layers() const noexcept { return GLsizei(m_layers.size()); }
+
+        // Every layer fills the whole array, so this is the same for every layer
+        [[nodiscard]] texture_rectangle rectangle(texture_array_index _layer) const noexcept {
+            return texture_rectangle{_layer, texture_rectangle::from_corner_and_dimensions, {0, 0}, 1.0f, 1.0f};
+        }
+
+        // Returns _source with the declarations of sample_virtual_texture inserted after its
+        // #version line, which must be the first line of _source apart from whitespace.
+        [[nodiscard]] std::string prepare_shader_source(std::string_view _source) const noexcept(!"Throws on error");
+
+        template<typename Capabilities>
+        void bind(shader_uniform_writer<Capabilities> const& _uniforms, GLint _textureUnit = 0, GLint _pageTableUnit = 1) const
+            noexcept(!"Throws on error") {
+            glActiveTexture(GL_TEXTURE0 + _pageTableUnit);
+            glBindTexture(GL_TEXTURE_BUFFER, m_pageTableTexture.value());
+
+            glActiveTexture(GL_TEXTURE0 + _textureUnit);
+            glBindTexture(GL_TEXTURE_2D_ARRAY, m_array.raw_id(impl_call).value);
+
+            _uniforms.set_int(texture_sampler_name, _textureUnit);
+            _uniforms.set_int(page_table_sampler_name, _pageTableUnit);
+        }
+
+        [[nodiscard]] static bool sparse_supported() noexcept;
+
+    private:
+        static auto constexpr not_resident = GLint(-1);
+
+        struct layer_state {
+            GLint physicalLayer = not_resident;
+            GLint finestLevel = 0;    // Finest mip level in memory, if resident
+            GLint requestedLevel = 0;
+            std::int64_t lastRequestedFrame = -1;
+        };
+
+        [[nodiscard]] static virtual_texture_backing choose_backing(GLsizei _layerWidth,
+                                                                    GLsizei _layerHeight,
+                                                                    GLsizei _virtualLayers,
+                                                                    std::optional<virtual_texture_backing> _backing) noexcept;
+
+        [[nodiscard]] static unique_texture_array make_backing_array(virtual_texture_backing _backing,
+                                                                     GLsizei _layerWidth,
+                                                                     GLsizei _layerHeight,
+                                                                     GLsizei _virtualLayers,
+                                                                     std::size_t _budgetBytes) noexcept(!"Throws on error");
+
+        [[nodiscard]] std::size_t level_bytes(GLint _level) const noexcept;
+        [[nodiscard]] std::size_t bytes_for_levels(GLint _finestLevel, GLint _coarsestLevel) const noexcept;
+
+        // Bytes needed for _state to hold _finestLevel and every coarser level
+        [[nodiscard]] std::size_t additional_bytes(layer_state const& _state, GLint _finestLevel) const noexcept;
+
+        bool make_room(std::size_t _bytes) noexcept;
+        void load(GLint _layer, GLint _finestLevel) noexcept(!"Throws on error");
+        void evict(GLint _layer) noexcept;
+
+        void set_commitment(GLint _layer, GLint _finestLevel, GLint _endLevel, bool _commit) noexcept;
+        void set_shared_mip_tail_commitment(bool _commit) noexcept;
+
+        virtual_texture_backing m_backing;
+        unique_texture_array m_array;
+
+        loader m_loader;
+        std::size_t m_budgetBytes;
+        std::size_t m_committedBytes = 0;
+
+        // Sparse backing only; levels from this one on form the mip tail, which is
+        // committed for a layer all at once
+        GLint m_sparseLevels = 0;
+
+        // Sparse backing only. Without GL_SPARSE_TEXTURE_FULL_ARRAY_CUBE_MIPMAPS_ARB, every
+        // layer shares one mip tail, which is committed while any layer is resident.
+        bool m_sharedMipTail = false;
+        GLsizei m_mipTailUsers = 0;
+
+        std::vector<layer_state> m_layers;
+        std::vector<GLint> m_requestedThisFrame;
+        std::vector<GLint> m_residentLayers;
+        std::vector<GLint> m_freePhysicalLayers;    // Page table backing only
+
+        // Entries are (physical layer, finest resident level), as read by the shader
+        std::vector<std::array<GLint, 2>> m_pageTable;
+        bool m_pageTableDirty = false;
+
+        gl_detail::unique_buffer_id<virtual_texture_detail::page_table_buffer_tag> m_pageTableBuffer;
+        gl_detail::unique_texture_id m_pageTableTexture;
+
+        std::int64_t m_frame = 0;
+    };
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,221 @@
+#include "randomcat/engine/textures/graphics/hot_reload.hpp"
+
+#if RC_ENGINE_HOT_RELOAD
+#    include <algorithm>
+#    include <chrono>
+#    include <fstream>
+#    include <sstream>
+
+#    include "randomcat/engine/low_level/detail/log.hpp"
+#    include "randomcat/engine/textures/graphics/texture_fs.hpp"
+#    include "randomcat/engine/textures/graphics/texture_mipmap.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        using namespace std::chrono_literals;
+
+        // How long the worker blocks before checking whether it should stop; interrupt
+        // normally wakes it sooner
+        auto constexpr poll_interval = 500ms;
+
+        // Editors may write a file in several steps, so wait for them to finish before reading
+        auto constexpr settle_time = 50ms;
+
+        [[nodiscard]] std::optional<std::string> read_file(fs::path const& _path) noexcept(!"Allocates") {
+            auto stream = std::ifstream(_path, std::ios::binary);
+            if (!stream) return std::nullopt;
+
+            auto contents = std::ostringstream();
+            contents << stream.rdbuf();
+            return contents.str();
+        }
+    }    // namespace
+
+    hot_reloader::hot_reloader() noexcept(false) : m_worker([this] { run_worker(); }) {}
+
+    hot_reloader::~hot_reloader() noexcept {
+        m_stopping = true;
+        m_watcher.interrupt();
+        m_worker.join();
+    }
+
+    void hot_reloader::watch_texture(texture_manager& _manager, fs::path const& _path) noexcept(false) {
+        // The name load_texture_file gives the texture
+        add_texture_watch(_path, texture_watch{&_manager, _path.relative_path().string(), nullptr, std::nullopt});
+    }
+
+    void hot_reloader::watch_texture(texture_manager& _manager,
+                                     fs::path const& _path,
+                                     unique_texture_array const& _array,
+                                     texture_array_index _layer) noexcept(false) {
+        add_texture_watch(_path, texture_watch{&_manager, _path.relative_path().string(), &_array, _layer});
+    }
+
+    void hot_reloader::add_texture_watch(fs::path const& _path, texture_watch _watch) noexcept(false) {
+        auto const key = m_watcher.watch(_path).string();
+
+        auto const lock = std::lock_guard(m_mutex);
+        m_textureWatches[key].push_back(std::move(_watch));
+    }
+
+    void hot_reloader::add_shader_watch(relink_function _relink,
+                                        fs::path const& _vertexPath,
+                                        fs::path const& _fragmentPath,
+                                        std::function<void()> _onReload) noexcept(false) {
+        auto const vertexKey = m_watcher.watch(_vertexPath).string();
+        auto const fragmentKey = m_watcher.watch(_fragmentPath).string();
+
+        auto const lock = std::lock_guard(m_mutex);
+
+        auto const index = m_shaderWatches.size();
+        m_shaderWatches.push_back(shader_watch{std::move(_relink), vertexKey, fragmentKey, std::move(_onReload)});
+
+        m_shaderIndices[vertexKey].push_back(index);
+        if (fragmentKey != vertexKey) m_shaderIndices[fragmentKey].push_back(index);
+    }
+
+    void hot_reloader::run_worker() noexcept {
+        while (!m_stopping) {
+            try {
+                auto changed = m_watcher.wait_for_changes(poll_interval);
+                if (changed.empty()) continue;
+
+                std::this_thread::sleep_for(settle_time);
+
+                for (auto& path : m_watcher.wait_for_changes(0ms)) {
+                    if (std::find(begin(changed), end(changed), path) == end(changed)) changed.push_back(std::move(path));
+                }
+
+                for (auto const& path : changed) reload(path);
+            } catch (std::exception const& _exception) {
+                log::error << "Hot reloading stopped: " << _exception.what();
+                return;
+            }
+        }
+    }
+
+    void hot_reloader::reload(fs::path const& _path) noexcept {
+        auto const key = _path.string();
+
+        auto isTexture = false;
+        auto shaders = std::vector<std::pair<std::size_t, std::pair<fs::path, fs::path>>>();
+
+        {
+            auto const lock = std::lock_guard(m_mutex);
+
+            isTexture = m_textureWatches.find(key) != end(m_textureWatches);
+
+            if (auto const indices = m_shaderIndices.find(key); indices != end(m_shaderIndices)) {
+                for (auto index : indices->second) {
+                    shaders.push_back({index, {m_shaderWatches[index].vertexPath, m_shaderWatches[index].fragmentPath}});
+                }
+            }
+        }
+
+        if (isTexture) {
+            try {
+                auto pixels = load_texture_file(_path);
+
+                auto const lock = std::lock_guard(m_mutex);
+
+                // A later change supersedes one that was never applied
+                auto const existing =
+                    std::find_if(begin(m_pendingTextures), end(m_pendingTextures), [&](auto const& _pending) { return _pending.path == _path; });
+
+                if (existing != end(m_pendingTextures)) {
+                    existing->pixels = std::move(pixels);
+                } else {
+                    m_pendingTextures.push_back(pending_texture{_path, std::move(pixels)});
+                }
+            } catch (texture_load_error const& _error) { log::warn << "Unable to reload texture: " << _error.what(); }
+        }
+
+        for (auto const& [index, paths] : shaders) {
+            auto vertex = read_file(paths.first);
+            auto fragment = read_file(paths.second);
+
+            if (!vertex || !fragment) {
+                log::warn << "Unable to read shader sources " << paths.first.string() << " and " << paths.second.string();
+                continue;
+            }
+
+            auto const lock = std::lock_guard(m_mutex);
+
+            auto const existing =
+                std::find_if(begin(m_pendingShaders), end(m_pendingShaders), [&, index = index](auto const& _pending) { return _pending.index == index; });
+
+            if (existing != end(m_pendingShaders)) {
+                existing->vertex = std::move(*vertex);
+                existing->fragment = std::move(*fragment);
+            } else {
+                m_pendingShaders.push_back(pending_shader{index, std::move(*vertex), std::move(*fragment)});
+            }
+        }
+    }
+
+    std::size_t hot_reloader::apply_pending() noexcept {
+        std::vector<pending_texture> textures;
+        std::vector<pending_shader> shaders;
+
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            if (m_pendingTextures.empty() && m_pendingShaders.empty()) return 0;
+
+            std::swap(textures, m_pendingTextures);
+            std::swap(shaders, m_pendingShaders);
+        }
+
+        for (auto const& pending : textures) apply(pending);
+        for (auto const& pending : shaders) apply(pending);
+
+        return textures.size() + shaders.size();
+    }
+
+    void hot_reloader::apply(pending_texture const& _pending) noexcept {
+        auto watches = std::vector<texture_watch>();
+
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            watches = m_textureWatches.at(_pending.path.string());
+        }
+
+        for (auto const& watch : watches) {
+            try {
+                auto const& old = watch.manager->get_texture(watch.name);
+
+                if (watch.array && (old.width() != _pending.pixels.width() || old.height() != _pending.pixels.height())) {
+                    log::warn << "Texture " << watch.name << " changed size, restart to reload it";
+                    continue;
+                }
+
+                watch.manager->replace_texture(watch.name, _pending.pixels);
+
+                if (watch.array) (void)bind_texture_array_layer_mipmapped(*watch.array, *watch.layer, _pending.pixels);
+
+                log::info << "Reloaded texture " << watch.name;
+            } catch (no_such_texture_error const&) { log::warn << "Texture " << watch.name << " was removed, not reloading it"; }
+        }
+    }
+
+    void hot_reloader::apply(pending_shader const& _pending) noexcept {
+        auto watch = std::optional<shader_watch>();
+
+        {
+            auto const lock = std::lock_guard(m_mutex);
+            watch = m_shaderWatches[_pending.index];
+        }
+
+        try {
+            watch->relink(_pending.vertex, _pending.fragment);
+        } catch (std::exception const& _error) {
+            log::warn << "Unable to reload shader " << watch->vertexPath.string() << ": " << _error.what();
+            return;
+        }
+
+        if (watch->onReload) watch->onReload();
+
+        log::info << "Reloaded shader " << watch->vertexPath.string();
+    }
+}    // namespace randomcat::engine::graphics::textures
+
+#endif
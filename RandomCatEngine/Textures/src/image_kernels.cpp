@@ -0,0 +1,399 @@
+#include "randomcat/engine/textures/graphics/image_kernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "randomcat/engine/low_level/detail/cpu_features.hpp"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#    define RC_IMAGE_KERNELS_X86 1
+#    include <immintrin.h>
+#else
+#    define RC_IMAGE_KERNELS_X86 0
+#endif
+
+namespace randomcat::engine::graphics::textures::image_kernels {
+    namespace {
+        auto constexpr channels = std::size_t(4);
+
+        // Exact round(_value / 255) for _value in [0, 255 * 255]
+        [[nodiscard]] constexpr unsigned div_255(unsigned _value) noexcept {
+            auto const biased = _value + 128;
+            return (biased + (biased >> 8)) >> 8;
+        }
+
+        [[nodiscard]] isa effective_isa(isa _requested) noexcept {
+            auto const best = best_isa();
+            return _requested > best ? best : _requested;
+        }
+
+        namespace scalar {
+            void fill_rgba(pixel_value* _target, std::size_t _pixelCount, std::array<pixel_value, 4> _color) noexcept {
+                for (std::size_t i = 0; i < _pixelCount; ++i) { std::memcpy(_target + i * channels, _color.data(), channels); }
+            }
+
+            void expand_rgb_to_rgba(pixel_value* _target, pixel_value const* _source, std::size_t _pixelCount, pixel_value _alpha) noexcept {
+                for (std::size_t i = 0; i < _pixelCount; ++i) {
+                    _target[i * 4 + 0] = _source[i * 3 + 0];
+                    _target[i * 4 + 1] = _source[i * 3 + 1];
+                    _target[i * 4 + 2] = _source[i * 3 + 2];
+                    _target[i * 4 + 3] = _alpha;
+                }
+            }
+
+            void premultiply_alpha(pixel_value* _pixels, std::size_t _pixelCount) noexcept {
+                for (std::size_t i = 0; i < _pixelCount; ++i) {
+                    auto const pixel = _pixels + i * channels;
+                    auto const alpha = unsigned(pixel[3]);
+
+                    pixel[0] = pixel_value(div_255(pixel[0] * alpha));
+                    pixel[1] = pixel_value(div_255(pixel[1] * alpha));
+                    pixel[2] = pixel_value(div_255(pixel[2] * alpha));
+                }
+            }
+
+            void swizzle_rgba(pixel_value* _target, pixel_value const* _source, std::size_t _pixelCount, channel_order _order) noexcept {
+                for (std::size_t i = 0; i < _pixelCount; ++i) {
+                    pixel_value pixel[channels];
+                    std::memcpy(pixel, _source + i * channels, channels);
+
+                    for (std::size_t channel = 0; channel < channels; ++channel) { _target[i * channels + channel] = pixel[_order[channel] & 3]; }
+                }
+            }
+
+            // Averages the 2x2 blocks that produce output columns [_firstColumn, _targetWidth) of one output row
+            void downsample_row(pixel_value* _target,
+                                pixel_value const* _firstRow,
+                                pixel_value const* _secondRow,
+                                std::int32_t _sourceWidth,
+                                std::int32_t _firstColumn,
+                                std::int32_t _targetWidth) noexcept {
+                for (auto column = _firstColumn; column < _targetWidth; ++column) {
+                    auto const left = std::size_t(2 * column) * channels;
+                    auto const right = std::size_t(std::min(2 * column + 1, _sourceWidth - 1)) * channels;
+
+                    for (std::size_t channel = 0; channel < channels; ++channel) {
+                        auto const sum = unsigned(_firstRow[left + channel]) + _firstRow[right + channel] + _secondRow[left + channel]
+                                         + _secondRow[right + channel];
+
+                        _target[std::size_t(column) * channels + channel] = pixel_value((sum + 2) >> 2);
+                    }
+                }
+            }
+        }    // namespace scalar
+
+#if RC_IMAGE_KERNELS_X86
+        namespace ssse3 {
+            __attribute__((target("ssse3"))) void fill_rgba(pixel_value* _target, std::size_t _pixelCount, std::array<pixel_value, 4> _color) noexcept {
+                std::int32_t packed;
+                std::memcpy(&packed, _color.data(), sizeof(packed));
+
+                auto const value = _mm_set1_epi32(packed);
+
+                std::size_t i = 0;
+                for (; i + 4 <= _pixelCount; i += 4) { _mm_storeu_si128(reinterpret_cast<__m128i*>(_target + i * channels), value); }
+
+                scalar::fill_rgba(_target + i * channels, _pixelCount - i, _color);
+            }
+
+            __attribute__((target("ssse3"))) void expand_rgb_to_rgba(pixel_value* _target,
+                                                                     pixel_value const* _source,
+                                                                     std::size_t _pixelCount,
+                                                                     pixel_value _alpha) noexcept {
+                auto const shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+                auto const alpha = _mm_set1_epi32(std::int32_t(std::uint32_t(_alpha) << 24));
+
+                // Each load reads 16 bytes but only uses 12, so stop while 16 remain
+                std::size_t i = 0;
+                for (; i + 6 <= _pixelCount; i += 4) {
+                    auto const rgb = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_source + i * 3));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(_target + i * channels), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+                }
+
+                scalar::expand_rgb_to_rgba(_target + i * channels, _source + i * 3, _pixelCount - i, _alpha);
+            }
+
+            // (_color * _alpha) / 255 per 16-bit lane, rounded to nearest
+            __attribute__((target("ssse3"))) __m128i multiply_div_255(__m128i _color, __m128i _alpha) noexcept {
+                auto const biased = _mm_add_epi16(_mm_mullo_epi16(_color, _alpha), _mm_set1_epi16(128));
+                return _mm_srli_epi16(_mm_add_epi16(biased, _mm_srli_epi16(biased, 8)), 8);
+            }
+
+            __attribute__((target("ssse3"))) __m128i premultiply_4(__m128i _pixels) noexcept {
+                auto const zero = _mm_setzero_si128();
+                auto const broadcastAlpha = _mm_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+                auto const alphaMask = _mm_set1_epi32(std::int32_t(0xFF000000u));
+
+                auto const alpha = _mm_shuffle_epi8(_pixels, broadcastAlpha);
+
+                auto const low = multiply_div_255(_mm_unpacklo_epi8(_pixels, zero), _mm_unpacklo_epi8(alpha, zero));
+                auto const high = multiply_div_255(_mm_unpackhi_epi8(_pixels, zero), _mm_unpackhi_epi8(alpha, zero));
+
+                auto const colors = _mm_packus_epi16(low, high);
+                return _mm_or_si128(_mm_andnot_si128(alphaMask, colors), _mm_and_si128(alphaMask, _pixels));
+            }
+
+            __attribute__((target("ssse3"))) void premultiply_alpha(pixel_value* _pixels, std::size_t _pixelCount) noexcept {
+                std::size_t i = 0;
+                for (; i + 4 <= _pixelCount; i += 4) {
+                    auto const address = reinterpret_cast<__m128i*>(_pixels + i * channels);
+                    _mm_storeu_si128(address, premultiply_4(_mm_loadu_si128(address)));
+                }
+
+                scalar::premultiply_alpha(_pixels + i * channels, _pixelCount - i);
+            }
+
+            __attribute__((target("ssse3"))) __m128i swizzle_mask(channel_order _order) noexcept {
+                alignas(16) std::int8_t mask[16];
+
+                for (int pixel = 0; pixel < 4; ++pixel) {
+                    for (int channel = 0; channel < 4; ++channel) { mask[pixel * 4 + channel] = std::int8_t(pixel * 4 + (_order[channel] & 3)); }
+                }
+
+                return _mm_load_si128(reinterpret_cast<__m128i const*>(mask));
+            }
+
+            __attribute__((target("ssse3"))) void swizzle_rgba(pixel_value* _target,
+                                                               pixel_value const* _source,
+                                                               std::size_t _pixelCount,
+                                                               channel_order _order) noexcept {
+                auto const mask = swizzle_mask(_order);
+
+                std::size_t i = 0;
+                for (; i + 4 <= _pixelCount; i += 4) {
+                    auto const pixels = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_source + i * channels));
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(_target + i * channels), _mm_shuffle_epi8(pixels, mask));
+                }
+
+                scalar::swizzle_rgba(_target + i * channels, _source + i * channels, _pixelCount - i, _order);
+            }
+
+            __attribute__((target("ssse3"))) void downsample_row(pixel_value* _target,
+                                                                 pixel_value const* _firstRow,
+                                                                 pixel_value const* _secondRow,
+                                                                 std::int32_t _sourceWidth,
+                                                                 std::int32_t _targetWidth) noexcept {
+                auto const zero = _mm_setzero_si128();
+                auto const bias = _mm_set1_epi16(2);
+
+                // Each iteration reads 4 source pixels per row and writes 2 pixels
+                std::int32_t column = 0;
+                for (; 2 * column + 4 <= _sourceWidth && column + 2 <= _targetWidth; column += 2) {
+                    auto const offset = std::size_t(2 * column) * channels;
+
+                    auto const first = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_firstRow + offset));
+                    auto const second = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_secondRow + offset));
+
+                    // Vertical sums of source pixels 0 and 1, then 2 and 3
+                    auto const left = _mm_add_epi16(_mm_unpacklo_epi8(first, zero), _mm_unpacklo_epi8(second, zero));
+                    auto const right = _mm_add_epi16(_mm_unpackhi_epi8(first, zero), _mm_unpackhi_epi8(second, zero));
+
+                    // Horizontal sums; the low half of each holds one output pixel
+                    auto const leftSum = _mm_add_epi16(left, _mm_srli_si128(left, 8));
+                    auto const rightSum = _mm_add_epi16(right, _mm_srli_si128(right, 8));
+
+                    auto const averaged = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(leftSum, rightSum), bias), 2);
+                    _mm_storel_epi64(reinterpret_cast<__m128i*>(_target + std::size_t(column) * channels), _mm_packus_epi16(averaged, averaged));
+                }
+
+                scalar::downsample_row(_target, _firstRow, _secondRow, _sourceWidth, column, _targetWidth);
+            }
+        }    // namespace ssse3
+
+        namespace avx2 {
+            __attribute__((target("avx2"))) void fill_rgba(pixel_value* _target, std::size_t _pixelCount, std::array<pixel_value, 4> _color) noexcept {
+                std::int32_t packed;
+                std::memcpy(&packed, _color.data(), sizeof(packed));
+
+                auto const value = _mm256_set1_epi32(packed);
+
+                std::size_t i = 0;
+                for (; i + 8 <= _pixelCount; i += 8) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(_target + i * channels), value); }
+
+                ssse3::fill_rgba(_target + i * channels, _pixelCount - i, _color);
+            }
+
+            __attribute__((target("avx2"))) void expand_rgb_to_rgba(pixel_value* _target,
+                                                                    pixel_value const* _source,
+                                                                    std::size_t _pixelCount,
+                                                                    pixel_value _alpha) noexcept {
+                auto const shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,    //
+                                                      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+                auto const alpha = _mm256_set1_epi32(std::int32_t(std::uint32_t(_alpha) << 24));
+
+                // The second 16-byte load ends 28 bytes in, so stop while 30 remain
+                std::size_t i = 0;
+                for (; i + 10 <= _pixelCount; i += 8) {
+                    auto const low = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_source + i * 3));
+                    auto const high = _mm_loadu_si128(reinterpret_cast<__m128i const*>(_source + i * 3 + 12));
+                    auto const rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(_target + i * channels), _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alpha));
+                }
+
+                ssse3::expand_rgb_to_rgba(_target + i * channels, _source + i * 3, _pixelCount - i, _alpha);
+            }
+
+            __attribute__((target("avx2"))) __m256i multiply_div_255(__m256i _color, __m256i _alpha) noexcept {
+                auto const biased = _mm256_add_epi16(_mm256_mullo_epi16(_color, _alpha), _mm256_set1_epi16(128));
+                return _mm256_srli_epi16(_mm256_add_epi16(biased, _mm256_srli_epi16(biased, 8)), 8);
+            }
+
+            __attribute__((target("avx2"))) void premultiply_alpha(pixel_value* _pixels, std::size_t _pixelCount) noexcept {
+                auto const zero = _mm256_setzero_si256();
+                auto const broadcastAlpha = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,    //
+                                                             3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+                auto const alphaMask = _mm256_set1_epi32(std::int32_t(0xFF000000u));
+
+                std::size_t i = 0;
+                for (; i + 8 <= _pixelCount; i += 8) {
+                    auto const address = reinterpret_cast<__m256i*>(_pixels + i * channels);
+                    auto const pixels = _mm256_loadu_si256(address);
+                    auto const alpha = _mm256_shuffle_epi8(pixels, broadcastAlpha);
+
+                    // Unpacking and packing both work within 128-bit lanes, so pixel order is kept
+                    auto const low = multiply_div_255(_mm256_unpacklo_epi8(pixels, zero), _mm256_unpacklo_epi8(alpha, zero));
+                    auto const high = multiply_div_255(_mm256_unpackhi_epi8(pixels, zero), _mm256_unpackhi_epi8(alpha, zero));
+
+                    auto const colors = _mm256_packus_epi16(low, high);
+                    _mm256_storeu_si256(address, _mm256_or_si256(_mm256_andnot_si256(alphaMask, colors), _mm256_and_si256(alphaMask, pixels)));
+                }
+
+                ssse3::premultiply_alpha(_pixels + i * channels, _pixelCount - i);
+            }
+
+            __attribute__((target("avx2"))) void swizzle_rgba(pixel_value* _target,
+                                                              pixel_value const* _source,
+                                                              std::size_t _pixelCount,
+                                                              channel_order _order) noexcept {
+                auto const mask = _mm256_broadcastsi128_si256(ssse3::swizzle_mask(_order));
+
+                std::size_t i = 0;
+                for (; i + 8 <= _pixelCount; i += 8) {
+                    auto const pixels = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(_source + i * channels));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(_target + i * channels), _mm256_shuffle_epi8(pixels, mask));
+                }
+
+                ssse3::swizzle_rgba(_target + i * channels, _source + i * channels, _pixelCount - i, _order);
+            }
+        }    // namespace avx2
+#endif
+
+        [[nodiscard]] std::array<pixel_value, 256> make_transfer_table(bool _toLinear) noexcept {
+            std::array<pixel_value, 256> table;
+
+            for (std::size_t i = 0; i < table.size(); ++i) {
+                auto const value = double(i) / 255.0;
+                double converted;
+
+                if (_toLinear) {
+                    converted = value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+                } else {
+                    converted = value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+                }
+
+                table[i] = pixel_value(std::lround(converted * 255.0));
+            }
+
+            return table;
+        }
+
+        void apply_color_table(pixel_value* _pixels, std::size_t _pixelCount, std::array<pixel_value, 256> const& _table) noexcept {
+            for (std::size_t i = 0; i < _pixelCount; ++i) {
+                auto const pixel = _pixels + i * channels;
+
+                pixel[0] = _table[pixel[0]];
+                pixel[1] = _table[pixel[1]];
+                pixel[2] = _table[pixel[2]];
+            }
+        }
+    }    // namespace
+
+    isa best_isa() noexcept {
+#if RC_IMAGE_KERNELS_X86
+        auto const& features = util_detail::detected_cpu_features();
+
+        if (features.avx2) return isa::avx2;
+        if (features.ssse3) return isa::ssse3;
+#endif
+
+        return isa::scalar;
+    }
+
+    void fill_rgba(pixel_value* _target, std::size_t _pixelCount, std::array<pixel_value, 4> _color, isa _isa) noexcept {
+        switch (effective_isa(_isa)) {
+#if RC_IMAGE_KERNELS_X86
+            case isa::avx2: return avx2::fill_rgba(_target, _pixelCount, _color);
+            case isa::ssse3: return ssse3::fill_rgba(_target, _pixelCount, _color);
+#endif
+            default: return scalar::fill_rgba(_target, _pixelCount, _color);
+        }
+    }
+
+    void expand_rgb_to_rgba(pixel_value* _target, pixel_value const* _source, std::size_t _pixelCount, pixel_value _alpha, isa _isa) noexcept {
+        switch (effective_isa(_isa)) {
+#if RC_IMAGE_KERNELS_X86
+            case isa::avx2: return avx2::expand_rgb_to_rgba(_target, _source, _pixelCount, _alpha);
+            case isa::ssse3: return ssse3::expand_rgb_to_rgba(_target, _source, _pixelCount, _alpha);
+#endif
+            default: return scalar::expand_rgb_to_rgba(_target, _source, _pixelCount, _alpha);
+        }
+    }
+
+    void premultiply_alpha(pixel_value* _pixels, std::size_t _pixelCount, isa _isa) noexcept {
+        switch (effective_isa(_isa)) {
+#if RC_IMAGE_KERNELS_X86
+            case isa::avx2: return avx2::premultiply_alpha(_pixels, _pixelCount);
+            case isa::ssse3: return ssse3::premultiply_alpha(_pixels, _pixelCount);
+#endif
+            default: return scalar::premultiply_alpha(_pixels, _pixelCount);
+        }
+    }
+
+    void swizzle_rgba(pixel_value* _target, pixel_value const* _source, std::size_t _pixelCount, channel_order _order, isa _isa) noexcept {
+        switch (effective_isa(_isa)) {
+#if RC_IMAGE_KERNELS_X86
+            case isa::avx2: return avx2::swizzle_rgba(_target, _source, _pixelCount, _order);
+            case isa::ssse3: return ssse3::swizzle_rgba(_target, _source, _pixelCount, _order);
+#endif
+            default: return scalar::swizzle_rgba(_target, _source, _pixelCount, _order);
+        }
+    }
+
+    void srgb_to_linear(pixel_value* _pixels, std::size_t _pixelCount) noexcept {
+        static auto const table = make_transfer_table(true);
+        apply_color_table(_pixels, _pixelCount, table);
+    }
+
+    void linear_to_srgb(pixel_value* _pixels, std::size_t _pixelCount) noexcept {
+        static auto const table = make_transfer_table(false);
+        apply_color_table(_pixels, _pixelCount, table);
+    }
+
+    void downsample_rgba_2x(pixel_value* _target, pixel_value const* _source, std::int32_t _sourceWidth, std::int32_t _sourceHeight, isa _isa) noexcept {
+        auto const targetWidth = downsampled_dimension(_sourceWidth);
+        auto const targetHeight = downsampled_dimension(_sourceHeight);
+        auto const sourceStride = std::size_t(_sourceWidth) * channels;
+
+        // The 128-bit implementation is already bound by loads, so AVX2 uses it too
+        auto const vectorized = effective_isa(_isa) != isa::scalar;
+
+        for (std::int32_t row = 0; row < targetHeight; ++row) {
+            auto const firstRow = _source + std::size_t(2 * row) * sourceStride;
+            auto const secondRow = _source + std::size_t(std::min(2 * row + 1, _sourceHeight - 1)) * sourceStride;
+            auto const target = _target + std::size_t(row) * targetWidth * channels;
+
+#if RC_IMAGE_KERNELS_X86
+            if (vectorized) {
+                ssse3::downsample_row(target, firstRow, secondRow, _sourceWidth, targetWidth);
+                continue;
+            }
+#else
+            (void)vectorized;
+#endif
+
+            scalar::downsample_row(target, firstRow, secondRow, _sourceWidth, 0, targetWidth);
+        }
+    }
+}    // namespace randomcat::engine::graphics::textures::image_kernels
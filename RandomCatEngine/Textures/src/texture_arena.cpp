@@ -0,0 +1,40 @@
+#include "randomcat/engine/textures/graphics/texture_arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        [[nodiscard]] std::size_t align_up(std::size_t _value) noexcept {
+            return (_value + texture_arena::alignment - 1) / texture_arena::alignment * texture_arena::alignment;
+        }
+    }    // namespace
+
+    texture texture_arena::copy_texture(texture_view _source) noexcept(false) {
+        return make_texture(_source.width(), _source.height(), [&](private_image_ptr _target) {
+            auto const source = _source.data(impl_call);
+            std::copy(source, source + _source.size_bytes(), _target);
+        });
+    }
+
+    texture_arena::private_image_ptr texture_arena::allocate(std::size_t _bytes) noexcept(false) {
+        auto const size = align_up(std::max(_bytes, std::size_t(1)));
+
+        if (!m_block || m_used + size > m_blockCapacity) {
+            // Textures in the old block keep it alive for as long as they need it
+            auto const capacity = std::max(m_blockSize, size);
+            auto const memory = static_cast<private_image_ptr>(::operator new(capacity, std::align_val_t(alignment)));
+
+            m_block = std::shared_ptr<private_image_value>(memory, [](private_image_ptr _memory) {
+                ::operator delete(_memory, std::align_val_t(alignment));
+            });
+
+            m_blockCapacity = capacity;
+            m_used = 0;
+        }
+
+        auto const result = m_block.get() + m_used;
+        m_used += size;
+        return result;
+    }
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,134 @@
+#include "randomcat/engine/textures/graphics/texture_atlas.hpp"
+
+#include <limits>
+#include <string>
+
+namespace randomcat::engine::graphics::textures {
+    bool texture_atlas_packer::find_fit(skyline const& _skyline, dimension_t _width, dimension_t _height, skyline_fit& _fit) const noexcept {
+        auto bestTop = std::numeric_limits<dimension_t>::max();
+        auto bestNodeWidth = std::numeric_limits<dimension_t>::max();
+        auto found = false;
+
+        for (std::size_t i = 0; i < _skyline.size(); ++i) {
+            auto const x = _skyline[i].x;
+            if (x + _width > m_layerWidth) break;
+
+            // The rectangle rests on the highest node it spans
+            auto y = dimension_t(0);
+            auto remainingWidth = _width;
+
+            for (auto j = i; remainingWidth > 0; ++j) {
+                y = std::max(y, _skyline[j].y);
+                remainingWidth -= _skyline[j].width;
+            }
+
+            auto const top = y + _height;
+            if (top > m_layerHeight) continue;
+
+            if (top < bestTop || (top == bestTop && _skyline[i].width < bestNodeWidth)) {
+                bestTop = top;
+                bestNodeWidth = _skyline[i].width;
+                _fit = skyline_fit{i, y};
+                found = true;
+            }
+        }
+
+        return found;
+    }
+
+    void texture_atlas_packer::place(skyline& _skyline, skyline_fit _fit, dimension_t _width, dimension_t _height) noexcept(false) {
+        auto const x = _skyline[_fit.nodeIndex].x;
+        auto const newNode = skyline_node{x, _fit.y + _height, _width};
+
+        _skyline.insert(begin(_skyline) + _fit.nodeIndex, newNode);
+
+        // Shrink or remove the nodes now covered by the new node
+        for (auto i = _fit.nodeIndex + 1; i < _skyline.size();) {
+            auto& node = _skyline[i];
+            auto const coveredUntil = newNode.x + newNode.width;
+
+            if (node.x >= coveredUntil) break;
+
+            auto const overlap = coveredUntil - node.x;
+
+            if (overlap >= node.width) {
+                _skyline.erase(begin(_skyline) + i);
+            } else {
+                node.x += overlap;
+                node.width -= overlap;
+                break;
+            }
+        }
+
+        // Merge neighbours at the same height
+        for (std::size_t i = 0; i + 1 < _skyline.size();) {
+            if (_skyline[i].y == _skyline[i + 1].y) {
+                _skyline[i].width += _skyline[i + 1].width;
+                _skyline.erase(begin(_skyline) + i + 1);
+            } else {
+                ++i;
+            }
+        }
+    }
+
+    texture_atlas_placement texture_atlas_packer::pack(dimension_t _width, dimension_t _height) noexcept(false) {
+        // Padding copies edge texels, which an empty texture does not have
+        if (_width <= 0 || _height <= 0) {
+            throw texture_atlas_error{"Cannot pack empty texture of size " + std::to_string(_width) + "x" + std::to_string(_height) + " into atlas"};
+        }
+
+        auto const paddedWidth = _width + 2 * m_padding;
+        auto const paddedHeight = _height + 2 * m_padding;
+
+        if (paddedWidth > m_layerWidth || paddedHeight > m_layerHeight) {
+            throw texture_atlas_error{"Texture of size " + std::to_string(_width) + "x" + std::to_string(_height) + " does not fit in atlas layer of size "
+                                      + std::to_string(m_layerWidth) + "x" + std::to_string(m_layerHeight)};
+        }
+
+        m_usedArea += std::int64_t(paddedWidth) * std::int64_t(paddedHeight);
+
+        for (std::size_t layer = 0; layer < m_layers.size(); ++layer) {
+            skyline_fit fit;
+
+            if (find_fit(m_layers[layer], paddedWidth, paddedHeight, fit)) {
+                auto const x = m_layers[layer][fit.nodeIndex].x;
+                place(m_layers[layer], fit, paddedWidth, paddedHeight);
+
+                return texture_atlas_placement{{GLint(layer)}, x + m_padding, fit.y + m_padding, _width, _height};
+            }
+        }
+
+        m_layers.push_back(skyline{skyline_node{0, 0, m_layerWidth}});
+        place(m_layers.back(), skyline_fit{0, 0}, paddedWidth, paddedHeight);
+
+        return texture_atlas_placement{{GLint(m_layers.size() - 1)}, m_padding, m_padding, _width, _height};
+    }
+
+    namespace texture_atlas_detail {
+        void fill_padded_image(texture_view _texture, texture::dimension_t _padding, std::vector<texture::private_image_value>& _staging) noexcept(false) {
+            auto constexpr channels = texture::channels;
+
+            auto const width = _texture.width();
+            auto const height = _texture.height();
+            auto const paddedWidth = width + 2 * _padding;
+            auto const paddedHeight = height + 2 * _padding;
+
+            _staging.resize(std::size_t(paddedWidth) * std::size_t(paddedHeight) * channels);
+
+            auto const source = _texture.data(impl_call);
+
+            for (texture::dimension_t row = 0; row < paddedHeight; ++row) {
+                auto const sourceRow = std::clamp(row - _padding, texture::dimension_t(0), height - 1);
+                auto const sourceBegin = source + std::size_t(sourceRow) * width * channels;
+                auto const target = _staging.data() + std::size_t(row) * paddedWidth * channels;
+
+                for (texture::dimension_t column = 0; column < _padding; ++column) {
+                    std::copy(sourceBegin, sourceBegin + channels, target + column * channels);
+                    std::copy(sourceBegin + (width - 1) * channels, sourceBegin + width * channels, target + (_padding + width + column) * channels);
+                }
+
+                std::copy(sourceBegin, sourceBegin + width * channels, target + _padding * channels);
+            }
+        }
+    }    // namespace texture_atlas_detail
+}    // namespace randomcat::engine::graphics::textures
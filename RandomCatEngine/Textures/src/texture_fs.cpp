@@ -1,25 +1,98 @@
 #include <randomcat/util/optional_filesystem.hpp>
 
 #if RC_HAVE_FILESYSTEM
+#    include <algorithm>
+#    include <atomic>
+#    include <memory>
+#    include <thread>
+
 #    include <gsl/gsl_util>
 #    include <stb/stb_image.hpp>
 
+#    include "randomcat/engine/low_level/profiling.hpp"
+#    include "randomcat/engine/textures/graphics/image_kernels.hpp"
 #    include "randomcat/engine/textures/graphics/texture_fs.hpp"
 
 namespace randomcat::engine::graphics::textures {
     texture load_texture_file(fs::path const& _path) noexcept(false) {
+        RC_PROFILE_SCOPE("load texture file");
+
+        auto const path = absolute(_path);
+
         // Raw use of int required by stbi
-        int width, height, burn;
-        auto data = stbi_load(absolute(_path).c_str(), &width, &height, &burn, STBI_rgb_alpha);
+        int width, height, fileChannels;
+
+        // Decoded once in the file's own format. stbi adds the alpha channel to RGB images one
+        // pixel at a time, so those are expanded with the vectorized kernel instead.
+        auto const fileData = stbi_load(path.c_str(), &width, &height, &fileChannels, 0);
+        if (fileData == nullptr) { throw texture_load_error{"Unable to load texture with path: " + _path.string()}; }
+
+        if (fileChannels == STBI_rgb_alpha) {
+            return texture{impl_call, gsl::narrow<std::int32_t>(width), gsl::narrow<std::int32_t>(height), texture::stbi_memory, fileData};
+        }
+
+        auto const freeFileData = gsl::finally([&] { stbi_image_free(fileData); });
+
+        auto const pixels = std::size_t(width) * std::size_t(height);
+        auto data = std::unique_ptr<texture::private_image_value[]>(new texture::private_image_value[pixels * texture::channels]);
+
+        if (fileChannels == STBI_rgb) {
+            image_kernels::expand_rgb_to_rgba(data.get(), fileData, pixels);
+        } else {
+            // Grey, optionally with alpha
+            auto const hasAlpha = fileChannels == STBI_grey_alpha;
+
+            for (std::size_t i = 0; i < pixels; ++i) {
+                auto const* source = fileData + i * std::size_t(fileChannels);
+                auto* target = data.get() + i * texture::channels;
 
-        if (data == nullptr) { throw texture_load_error{"Unable to load texture with path: " + _path.string()}; }
+                target[0] = target[1] = target[2] = source[0];
+                target[3] = hasAlpha ? source[1] : 255;
+            }
+        }
 
-        return texture{impl_call, gsl::narrow<std::int32_t>(width), gsl::narrow<std::int32_t>(height), texture::stbi_memory, data};
+        return texture{impl_call, gsl::narrow<std::int32_t>(width), gsl::narrow<std::int32_t>(height), texture::take_ownership, std::move(data)};
     }
 
     texture const& load_texture_file(texture_manager& _manager, fs::path const& _path) noexcept(false) {
         return _manager.add_texture(_path.relative_path().string(), load_texture_file(_path));
     }
+
+    namespace {
+        struct async_load_state {
+            std::vector<fs::path> paths;
+            std::vector<std::promise<texture>> promises;
+            std::atomic<std::size_t> nextIndex{0};
+        };
+
+        void run_async_load_worker(std::shared_ptr<async_load_state> _state) noexcept {
+            while (true) {
+                auto const index = _state->nextIndex++;
+                if (index >= _state->paths.size()) return;
+
+                try {
+                    _state->promises[index].set_value(load_texture_file(_state->paths[index]));
+                } catch (...) { _state->promises[index].set_exception(std::current_exception()); }
+            }
+        }
+    }    // namespace
+
+    std::vector<std::future<texture>> load_texture_files_async(std::vector<fs::path> _paths) noexcept(false) {
+        auto state = std::make_shared<async_load_state>();
+        state->paths = std::move(_paths);
+        state->promises.resize(state->paths.size());
+
+        std::vector<std::future<texture>> futures;
+        futures.reserve(state->promises.size());
+        std::transform(begin(state->promises), end(state->promises), std::back_inserter(futures), [](auto& promise) { return promise.get_future(); });
+
+        auto const workerCount = std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), state->paths.size());
+
+        // Workers hold the state alive, so they may outlive the returned futures
+        for (std::size_t i = 0; i < workerCount; ++i) { std::thread(run_async_load_worker, state).detach(); }
+
+        return futures;
+    }
 }    // namespace randomcat::engine::graphics::textures
 
 #endif
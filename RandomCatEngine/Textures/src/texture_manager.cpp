@@ -8,7 +8,7 @@
 #include "randomcat/engine/low_level/detail/log.hpp"
 
 namespace randomcat::engine::graphics::textures {
-    texture::stbi_underlying::~stbi_underlying() noexcept { stbi_image_free(m_stbiPtr); }
+    void texture_detail::free_stbi_image(image_value* _data) noexcept { stbi_image_free(_data); }
 
     texture const& texture_manager::get_texture(std::string_view _path) const {
         auto it = texture_iter(_path);
@@ -28,11 +28,11 @@ namespace randomcat::engine::graphics::textures {
     }
 
     texture_manager::map_iter_t texture_manager::texture_iter(std::string_view _name) noexcept {
-        return std::find_if(begin(m_textureMap), end(m_textureMap), [&](auto node) { return node.first == _name; });
+        return m_textureMap.find(std::string(_name));
     }
 
     texture_manager::map_const_iter_t texture_manager::texture_iter(std::string_view _name) const noexcept {
-        return std::find_if(begin(m_textureMap), end(m_textureMap), [&](auto node) { return node.first == _name; });
+        return m_textureMap.find(std::string(_name));
     }
 
     texture const& texture_manager::add_texture(std::string _newName, texture _texture) noexcept(false) {
@@ -47,6 +47,14 @@ namespace randomcat::engine::graphics::textures {
         return insertResult.first->second;
     }
 
+    texture const& texture_manager::replace_texture(std::string_view _name, texture _texture) noexcept(false) {
+        auto it = texture_iter(_name);
+        if (it == end(m_textureMap)) { throw no_such_texture_error{"No texture registered with path: " + std::string(_name)}; }
+
+        it->second = std::move(_texture);
+        return it->second;
+    }
+
     void texture_manager::alias_texture(std::string _newName, std::string_view _oldName) noexcept(false) {
         add_texture(std::move(_newName), get_texture(_oldName));
     }
@@ -0,0 +1,26 @@
+#include "randomcat/engine/textures/graphics/texture_mipmap.hpp"
+
+#include <memory>
+
+namespace randomcat::engine::graphics::textures {
+    std::vector<texture> make_texture_mip_chain(texture_view _base) noexcept(false) {
+        std::vector<texture> result;
+
+        auto source = _base;
+
+        while (source.width() > 1 || source.height() > 1) {
+            auto const width = image_kernels::downsampled_dimension(source.width());
+            auto const height = image_kernels::downsampled_dimension(source.height());
+
+            // Not make_unique, which would zero memory that is about to be overwritten
+            auto data = std::unique_ptr<texture::private_image_value[]>(
+                new texture::private_image_value[std::size_t(width) * std::size_t(height) * texture::channels]);
+            image_kernels::downsample_rgba_2x(data.get(), source.data(impl_call), source.width(), source.height());
+
+            result.push_back(texture{impl_call, width, height, texture::take_ownership, std::move(data)});
+            source = result.back().view();
+        }
+
+        return result;
+    }
+}    // namespace randomcat::engine::graphics::textures
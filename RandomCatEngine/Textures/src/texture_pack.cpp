@@ -0,0 +1,221 @@
+#include "randomcat/engine/textures/graphics/texture_pack.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <gsl/gsl_util>
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        auto constexpr pack_magic = std::array<char, 4>{'R', 'C', 'T', 'P'};
+        auto constexpr pack_version = std::uint32_t(1);
+
+        // Texel data is aligned so it can be handed straight to GL or SIMD code
+        auto constexpr data_alignment = std::uint64_t(64);
+
+        struct file_header {
+            std::array<char, 4> magic;
+            std::uint32_t version;
+            std::uint32_t entryCount;
+            std::uint32_t namesSize;
+        };
+
+        struct file_entry {
+            std::uint64_t dataOffset;
+            std::uint32_t width;
+            std::uint32_t height;
+            std::uint32_t nameOffset;
+            std::uint32_t nameLength;
+        };
+
+        [[nodiscard]] std::uint64_t align_up(std::uint64_t _value) noexcept { return (_value + data_alignment - 1) / data_alignment * data_alignment; }
+
+        [[nodiscard]] std::uint64_t texel_bytes(std::uint64_t _width, std::uint64_t _height) noexcept { return _width * _height * texture::channels; }
+
+        // Whether the texels of _entry lie within a file of _fileSize bytes. Every field comes
+        // from the file, so this must not overflow whatever they hold.
+        [[nodiscard]] bool texels_in_bounds(file_entry const& _entry, std::uint64_t _fileSize) noexcept {
+            if (_entry.dataOffset > _fileSize) return false;
+
+            auto const availableTexels = (_fileSize - _entry.dataOffset) / texture::channels;
+            return _entry.width == 0 || _entry.height <= availableTexels / _entry.width;
+        }
+
+        template<typename T>
+        void write_raw(std::ostream& _out, T const& _value) noexcept(!"Ostreaming not noexcept") {
+            _out.write(reinterpret_cast<char const*>(&_value), sizeof(T));
+        }
+    }    // namespace
+
+    void texture_pack_writer::add_texture(std::string _name, texture const& _texture) noexcept(false) {
+        m_entries.push_back(pending_entry{std::move(_name), std::cref(_texture)});
+    }
+
+    void texture_pack_writer::write(fs::path const& _path) const noexcept(false) {
+        auto sorted = m_entries;
+        std::sort(begin(sorted), end(sorted), [](auto const& _first, auto const& _second) { return _first.name < _second.name; });
+
+        auto const duplicate = std::adjacent_find(begin(sorted), end(sorted), [](auto const& _first, auto const& _second) {
+            return _first.name == _second.name;
+        });
+
+        if (duplicate != end(sorted)) throw texture_pack_error{"Duplicate texture name in pack: " + duplicate->name};
+
+        std::string names;
+        std::vector<file_entry> entries;
+        entries.reserve(sorted.size());
+
+        for (auto const& pending : sorted) {
+            entries.push_back(file_entry{0,
+                                         gsl::narrow<std::uint32_t>(pending.image.get().width()),
+                                         gsl::narrow<std::uint32_t>(pending.image.get().height()),
+                                         gsl::narrow<std::uint32_t>(names.size()),
+                                         gsl::narrow<std::uint32_t>(pending.name.size())});
+            names += pending.name;
+        }
+
+        auto offset = align_up(sizeof(file_header) + entries.size() * sizeof(file_entry) + names.size());
+
+        for (auto& entry : entries) {
+            entry.dataOffset = offset;
+            offset = align_up(offset + texel_bytes(entry.width, entry.height));
+        }
+
+        std::ofstream out(_path, std::ios::binary | std::ios::trunc);
+        if (!out) throw texture_pack_error{"Unable to open texture pack for writing: " + _path.string()};
+
+        write_raw(out, file_header{pack_magic, pack_version, gsl::narrow<std::uint32_t>(entries.size()), gsl::narrow<std::uint32_t>(names.size())});
+        for (auto const& entry : entries) write_raw(out, entry);
+        out.write(names.data(), names.size());
+
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            // Pad up to the aligned start of this texture's data
+            auto const padding = entries[i].dataOffset - std::uint64_t(out.tellp());
+            std::fill_n(std::ostreambuf_iterator<char>(out), padding, '\0');
+
+            out.write(reinterpret_cast<char const*>(sorted[i].image.get().data(impl_call)), texel_bytes(entries[i].width, entries[i].height));
+        }
+
+        if (!out) throw texture_pack_error{"Error writing texture pack: " + _path.string()};
+    }
+
+    struct texture_pack::mapping {
+        mapping(void* _address, std::size_t _size) noexcept : address(_address), size(_size) {}
+
+        mapping(mapping const&) = delete;
+        mapping(mapping&&) = delete;
+
+        ~mapping() noexcept { munmap(address, size); }
+
+        void* address;
+        std::size_t size;
+    };
+
+    texture_pack::texture_pack(fs::path const& _path) noexcept(false) {
+        auto const fd = ::open(_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) throw texture_pack_error{"Unable to open texture pack: " + _path.string()};
+
+        auto const closeFd = gsl::finally([&] { ::close(fd); });
+
+        struct stat fileStat;
+        if (::fstat(fd, &fileStat) != 0) throw texture_pack_error{"Unable to stat texture pack: " + _path.string()};
+
+        auto const fileSize = std::size_t(fileStat.st_size);
+        if (fileSize < sizeof(file_header)) throw texture_pack_error{"Texture pack is truncated: " + _path.string()};
+
+        // Private and writable so that the texel pointers can be handed out as-is; pages
+        // are only copied if something writes to them, which nothing should
+        auto const address = ::mmap(nullptr, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (address == MAP_FAILED) throw texture_pack_error{"Unable to map texture pack: " + _path.string()};
+
+        m_mapping = std::make_shared<mapping>(address, fileSize);
+
+        auto const base = static_cast<texture::private_image_ptr>(address);
+
+        file_header header;
+        std::memcpy(&header, base, sizeof(header));
+
+        if (header.magic != pack_magic) throw texture_pack_error{"Not a texture pack: " + _path.string()};
+        if (header.version != pack_version) throw texture_pack_error{"Unsupported texture pack version in: " + _path.string()};
+
+        auto const namesOffset = sizeof(file_header) + std::uint64_t(header.entryCount) * sizeof(file_entry);
+        if (namesOffset + header.namesSize > fileSize) throw texture_pack_error{"Texture pack index is truncated: " + _path.string()};
+
+        auto const names = reinterpret_cast<char const*>(base + namesOffset);
+
+        m_entries.reserve(header.entryCount);
+
+        for (std::uint32_t i = 0; i < header.entryCount; ++i) {
+            file_entry fileEntry;
+            std::memcpy(&fileEntry, base + sizeof(file_header) + i * sizeof(file_entry), sizeof(fileEntry));
+
+            auto const nameInBounds = std::uint64_t(fileEntry.nameOffset) + fileEntry.nameLength <= header.namesSize;
+
+            if (!nameInBounds || !texels_in_bounds(fileEntry, fileSize)) {
+                throw texture_pack_error{"Texture pack entry out of bounds in: " + _path.string()};
+            }
+
+            auto constexpr maxDimension = std::uint32_t(std::numeric_limits<texture::dimension_t>::max());
+
+            if (fileEntry.width > maxDimension || fileEntry.height > maxDimension) {
+                throw texture_pack_error{"Texture pack entry too large in: " + _path.string()};
+            }
+
+            m_entries.push_back(entry{std::string_view(names + fileEntry.nameOffset, fileEntry.nameLength),
+                                      texture::dimension_t(fileEntry.width),
+                                      texture::dimension_t(fileEntry.height),
+                                      base + fileEntry.dataOffset});
+        }
+
+        // The writer sorts entries, but do not rely on it for lookups
+        std::sort(begin(m_entries), end(m_entries), [](auto const& _first, auto const& _second) { return _first.name < _second.name; });
+    }
+
+    bool texture_pack::has_texture(std::string_view _name) const noexcept {
+        return std::binary_search(begin(m_entries), end(m_entries), entry{_name, 0, 0, nullptr}, [](auto const& _first, auto const& _second) {
+            return _first.name < _second.name;
+        });
+    }
+
+    texture texture_pack::get_texture(std::string_view _name) const noexcept(false) { return make_texture(find_entry(_name)); }
+
+    texture_view texture_pack::view_texture(std::string_view _name) const noexcept(false) {
+        auto const& found = find_entry(_name);
+        return texture_view(found.width, found.height, found.data);
+    }
+
+    texture_pack::entry const& texture_pack::find_entry(std::string_view _name) const noexcept(false) {
+        auto const it = std::lower_bound(begin(m_entries), end(m_entries), _name, [](auto const& _entry, std::string_view _value) {
+            return _entry.name < _value;
+        });
+
+        if (it == end(m_entries) || it->name != _name) throw no_such_texture_error{"No texture in pack with name: " + std::string(_name)};
+
+        return *it;
+    }
+
+    std::vector<std::string_view> texture_pack::names() const noexcept(false) {
+        std::vector<std::string_view> result;
+        result.reserve(m_entries.size());
+        std::transform(begin(m_entries), end(m_entries), std::back_inserter(result), [](auto const& _entry) { return _entry.name; });
+        return result;
+    }
+
+    void texture_pack::add_all_to(texture_manager& _manager) const noexcept(false) {
+        for (auto const& current : m_entries) { _manager.add_texture(std::string(current.name), make_texture(current)); }
+    }
+
+    texture texture_pack::make_texture(entry const& _entry) const noexcept {
+        return texture{impl_call, _entry.width, _entry.height, texture::shared_memory, m_mapping, _entry.data};
+    }
+}    // namespace randomcat::engine::graphics::textures
@@ -0,0 +1,163 @@
+#include "randomcat/engine/textures/graphics/texture_residency.hpp"
+
+#include <utility>
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        [[nodiscard]] std::size_t texture_bytes(std::size_t _width, std::size_t _height) noexcept { return _width * _height * texture::channels; }
+
+        [[nodiscard]] GLsizei budget_layers(GLsizei _layerWidth, GLsizei _layerHeight, std::size_t _gpuBudgetBytes) noexcept(false) {
+            auto const layers = _gpuBudgetBytes / texture_bytes(_layerWidth, _layerHeight);
+
+            if (layers == 0) {
+                throw texture_residency_error{"GPU budget of " + std::to_string(_gpuBudgetBytes) + " bytes is too small for one "
+                                              + std::to_string(_layerWidth) + "x" + std::to_string(_layerHeight) + " layer"};
+            }
+
+            return GLsizei(layers);
+        }
+    }    // namespace
+
+    texture_residency::texture_residency(GLsizei _layerWidth, GLsizei _layerHeight, std::size_t _gpuBudgetBytes, std::size_t _cpuBudgetBytes) noexcept(
+        false)
+    : m_array(make_texture_array(_layerWidth, _layerHeight, budget_layers(_layerWidth, _layerHeight, _gpuBudgetBytes))),
+      m_cpuBudgetBytes(_cpuBudgetBytes) {
+        // Reversed so that layers are handed out from 0
+        for (auto layer = m_array.layers(impl_call); layer > 0; --layer) { m_freeLayers.push_back(texture_array_index{layer - 1}); }
+    }
+
+    void texture_residency::register_texture(std::string _name, loader _loader, cpu_copy_policy _policy) noexcept(false) {
+        if (is_registered(_name)) throw texture_duplicate_path_error{"Attempted register of path that already exists: " + _name};
+
+        auto name = _name;
+        m_entries.emplace(std::move(_name), entry{std::move(name), std::move(_loader), _policy});
+    }
+
+    bool texture_residency::unregister_texture(std::string_view _name) noexcept {
+        auto const it = m_entries.find(std::string(_name));
+        if (it == end(m_entries)) return false;
+
+        evict_gpu(it->second);
+        drop_cpu_copy(it->second);
+
+        m_entries.erase(it);
+        return true;
+    }
+
+    bool texture_residency::is_registered(std::string_view _name) const noexcept { return find_entry(_name) != nullptr; }
+
+    bool texture_residency::is_resident(std::string_view _name) const noexcept {
+        auto const found = find_entry(_name);
+        return found && found->layer;
+    }
+
+    texture_rectangle texture_residency::acquire(std::string_view _name) noexcept(false) {
+        auto const found = find_entry(_name);
+        if (!found) throw no_such_texture_error{"No texture registered with path: " + std::string(_name)};
+
+        auto& current = *found;
+        current.lastUsedFrame = m_frame;
+
+        if (current.layer) {
+            m_gpuLru.splice(begin(m_gpuLru), m_gpuLru, current.gpuLruPosition);
+            return *current.rectangle;
+        }
+
+        auto const layer = take_free_layer();
+
+        try {
+            auto pixels = [&] {
+                if (current.cpuCopy) {
+                    m_cpuLru.splice(begin(m_cpuLru), m_cpuLru, current.cpuLruPosition);
+                    return *current.cpuCopy;
+                }
+
+                ++m_stats.loads;
+                return current.load();
+            }();
+
+            if (pixels.width() > m_array.width(impl_call) || pixels.height() > m_array.height(impl_call)) {
+                throw texture_residency_error{"Texture " + current.name + " is larger than the residency layer size"};
+            }
+
+            current.rectangle.emplace(bind_texture_array_layer(m_array, layer, pixels));
+            current.layer = layer;
+            current.gpuLruPosition = m_gpuLru.insert(begin(m_gpuLru), &current);
+
+            ++m_stats.uploads;
+            m_stats.gpuBytes += layer_bytes();
+
+            if (current.policy == cpu_copy_policy::keep_within_budget && !current.cpuCopy) store_cpu_copy(current, std::move(pixels));
+
+            return *current.rectangle;
+        } catch (...) {
+            if (!current.layer) m_freeLayers.push_back(layer);
+            throw;
+        }
+    }
+
+    void texture_residency::release_cpu_copies() noexcept {
+        while (!m_cpuLru.empty()) drop_cpu_copy(*m_cpuLru.back());
+    }
+
+    texture_residency::entry* texture_residency::find_entry(std::string_view _name) noexcept {
+        auto const it = m_entries.find(std::string(_name));
+        return it != end(m_entries) ? &it->second : nullptr;
+    }
+
+    texture_residency::entry const* texture_residency::find_entry(std::string_view _name) const noexcept {
+        auto const it = m_entries.find(std::string(_name));
+        return it != end(m_entries) ? &it->second : nullptr;
+    }
+
+    std::size_t texture_residency::layer_bytes() const noexcept { return texture_bytes(m_array.width(impl_call), m_array.height(impl_call)); }
+
+    texture_array_index texture_residency::take_free_layer() noexcept(false) {
+        if (m_freeLayers.empty()) {
+            auto& victim = *m_gpuLru.back();
+
+            if (victim.lastUsedFrame == m_frame) {
+                throw texture_residency_error{"Textures used in one frame exceed the GPU budget of " + std::to_string(layer_count()) + " layers"};
+            }
+
+            evict_gpu(victim);
+        }
+
+        auto const layer = m_freeLayers.back();
+        m_freeLayers.pop_back();
+        return layer;
+    }
+
+    void texture_residency::evict_gpu(entry& _entry) noexcept {
+        if (!_entry.layer) return;
+
+        m_freeLayers.push_back(*_entry.layer);
+        m_gpuLru.erase(_entry.gpuLruPosition);
+        m_stats.gpuBytes -= layer_bytes();
+        ++m_stats.gpuEvictions;
+
+        _entry.layer.reset();
+        _entry.rectangle.reset();
+    }
+
+    void texture_residency::drop_cpu_copy(entry& _entry) noexcept {
+        if (!_entry.cpuCopy) return;
+
+        m_cpuLru.erase(_entry.cpuLruPosition);
+        m_stats.cpuBytes -= texture_bytes(_entry.cpuCopy->width(), _entry.cpuCopy->height());
+        ++m_stats.cpuEvictions;
+
+        _entry.cpuCopy.reset();
+    }
+
+    void texture_residency::store_cpu_copy(entry& _entry, texture _texture) noexcept(false) {
+        auto const bytes = texture_bytes(_texture.width(), _texture.height());
+        if (bytes > m_cpuBudgetBytes) return;
+
+        while (m_stats.cpuBytes + bytes > m_cpuBudgetBytes) drop_cpu_copy(*m_cpuLru.back());
+
+        _entry.cpuCopy.emplace(std::move(_texture));
+        _entry.cpuLruPosition = m_cpuLru.insert(begin(m_cpuLru), &_entry);
+        m_stats.cpuBytes += bytes;
+    }
+}    // namespace randomcat::engine::graphics::textures
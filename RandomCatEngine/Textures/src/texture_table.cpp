@@ -0,0 +1,108 @@
+#include "randomcat/engine/textures/graphics/texture_table.hpp"
+
+#include "randomcat/engine/low_level/detail/log.hpp"
+#include "randomcat/engine/low_level/graphics/render_stats.hpp"
+#include "randomcat/engine/low_level/graphics/shader_source.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        // sampler2D(uvec2) needs GLSL 4.00 as well as the extension
+        auto constexpr bindless_glsl_version = 400;
+
+        auto constexpr bindless_glsl_declarations = R"(
+#extension GL_ARB_bindless_texture : require
+
+layout (std140) uniform rc_texture_table {
+    uvec4 rc_textureHandles[1024];
+};
+
+vec4 sample_texture_table(int index, vec2 coord) {
+    uvec4 handlePair = rc_textureHandles[index / 2];
+    uvec2 handle = (index % 2 == 0) ? handlePair.xy : handlePair.zw;
+    return texture(sampler2D(handle), coord);
+}
+)";
+
+        auto constexpr array_glsl_declarations = R"(
+uniform sampler2DArray rc_texture_array;
+
+vec4 sample_texture_table(int index, vec2 coord) {
+    return texture(rc_texture_array, vec3(coord, index));
+}
+)";
+    }    // namespace
+
+    bool texture_table::bindless_supported() noexcept { return GLEW_ARB_bindless_texture; }
+
+    texture_table::texture_table(std::vector<texture_view> const& _textures, texture_table_mode _mode) noexcept(false) {
+        if (_mode == texture_table_mode::bindless && !bindless_supported()) {
+            throw texture_table_error{"Bindless texture table requested, but GL_ARB_bindless_texture is not supported"};
+        }
+
+        auto const useBindless = _mode == texture_table_mode::bindless || (_mode == texture_table_mode::automatic && bindless_supported());
+
+        if (useBindless) {
+            make_bindless(_textures);
+            return;
+        }
+
+        if (_mode == texture_table_mode::automatic) log::info << "GL_ARB_bindless_texture unavailable, texture table using a texture array";
+
+        auto built = make_texture_array_from_range(_textures);
+        m_array.emplace(std::move(built.first));
+        m_rectangles = std::move(built.second);
+    }
+
+    texture_table::~texture_table() noexcept {
+        // Handles must not be resident when their textures are deleted
+        for (auto handle : m_handles) glMakeTextureHandleNonResidentARB(handle);
+    }
+
+    void texture_table::make_bindless(std::vector<texture_view> const& _textures) noexcept(false) {
+        if (_textures.size() > max_bindless_textures) {
+            throw texture_table_error{"Bindless texture table holds at most " + std::to_string(max_bindless_textures) + " textures, "
+                                      + std::to_string(_textures.size()) + " given"};
+        }
+
+        m_textures.reserve(_textures.size());
+        m_handles.reserve(_textures.size());
+        m_rectangles.reserve(_textures.size());
+
+        for (std::size_t i = 0; i < _textures.size(); ++i) {
+            auto const& current = _textures[i];
+            auto& id = m_textures.emplace_back();
+
+            glBindTexture(GL_TEXTURE_2D, id.value());
+            glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, current.width(), current.height());
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, current.width(), current.height(), GL_RGBA, GL_UNSIGNED_BYTE, current.data(impl_call));
+            render_stats_detail::count_texture_upload(std::size_t(current.width()) * std::size_t(current.height()) * texture::channels);
+
+            // The handle captures the sampler state, so it must be set before this
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+            auto const handle = glGetTextureHandleARB(id.value());
+            glMakeTextureHandleResidentARB(handle);
+            m_handles.push_back(handle);
+
+            // Each texture has its own storage, so it always spans the whole coordinate range
+            m_rectangles.push_back(texture_rectangle{{GLint(i)}, texture_rectangle::from_corner_and_dimensions, {0, 0}, 1.0f, 1.0f});
+        }
+
+        // The buffer must cover the whole uniform block, even past the last texture
+        auto handleData = m_handles;
+        handleData.resize(max_bindless_textures, 0);
+
+        m_handleBuffer.emplace();
+        glBindBuffer(GL_UNIFORM_BUFFER, m_handleBuffer->value());
+        glBufferData(GL_UNIFORM_BUFFER, handleData.size() * sizeof(GLuint64), handleData.data(), GL_STATIC_DRAW);
+    }
+
+    std::string texture_table::prepare_shader_source(std::string_view _source) const noexcept(false) {
+        auto result = is_bindless() ? insert_shader_declarations(_source, bindless_glsl_declarations, bindless_glsl_version)
+                                    : insert_shader_declarations(_source, array_glsl_declarations);
+
+        if (!result) throw texture_table_error{"Shader source must start with a #version line"};
+
+        return std::move(*result);
+    }
+}    // namespace randomcat::engine::graphics::textures
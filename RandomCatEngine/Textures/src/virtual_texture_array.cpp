@@ -0,0 +1,364 @@
+#include "randomcat/engine/textures/graphics/virtual_texture_array.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "randomcat/engine/low_level/detail/log.hpp"
+#include "randomcat/engine/low_level/graphics/shader_source.hpp"
+#include "randomcat/engine/textures/graphics/texture_mipmap.hpp"
+
+namespace randomcat::engine::graphics::textures {
+    namespace {
+        // Derivatives are taken before the residency branch, as they are undefined in
+        // non-uniform control flow. The LOD is clamped so that levels that are not
+        // committed are never read.
+        auto constexpr glsl_declarations = R"(
+uniform sampler2DArray rc_virtual_texture;
+uniform isamplerBuffer rc_virtual_page_table;
+
+vec4 sample_virtual_texture(int layer, vec2 coord) {
+    vec2 texels = coord * vec2(textureSize(rc_virtual_texture, 0).xy);
+    vec2 dx = dFdx(texels);
+    vec2 dy = dFdy(texels);
+    float lod = 0.5 * log2(max(dot(dx, dx), dot(dy, dy)));
+
+    ivec2 entry = texelFetch(rc_virtual_page_table, layer).xy;
+    if (entry.x < 0) return vec4(0.0);
+
+    return textureLod(rc_virtual_texture, vec3(coord, entry.x), max(lod, float(entry.y)));
+}
+)";
+
+        [[nodiscard]] std::size_t full_chain_bytes(GLsizei _width, GLsizei _height) noexcept {
+            std::size_t result = 0;
+            auto const levels = texture_array_detail::full_mip_chain_levels(_width, _height);
+
+            for (GLint level = 0; level < levels; ++level) {
+                result += std::size_t(std::max(_width >> level, 1)) * std::size_t(std::max(_height >> level, 1)) * texture::channels;
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool sparse_usable(GLsizei _layerWidth, GLsizei _layerHeight, GLsizei _virtualLayers) noexcept {
+            if (!virtual_texture_array::sparse_supported()) return false;
+
+            GLint pageWidth = 0;
+            GLint pageHeight = 0;
+            GLint maxLayers = 0;
+
+            glGetInternalformativ(GL_TEXTURE_2D_ARRAY, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &pageWidth);
+            glGetInternalformativ(GL_TEXTURE_2D_ARRAY, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &pageHeight);
+            glGetIntegerv(GL_MAX_SPARSE_ARRAY_TEXTURE_LAYERS_ARB, &maxLayers);
+
+            return pageWidth > 0 && pageHeight > 0 && _layerWidth % pageWidth == 0 && _layerHeight % pageHeight == 0 && _virtualLayers <= maxLayers;
+        }
+    }    // namespace
+
+    bool virtual_texture_array::sparse_supported() noexcept { return GLEW_ARB_sparse_texture; }
+
+    virtual_texture_backing virtual_texture_array::choose_backing(GLsizei _layerWidth,
+                                                                  GLsizei _layerHeight,
+                                                                  GLsizei _virtualLayers,
+                                                                  std::optional<virtual_texture_backing> _backing) noexcept {
+        if (_backing == virtual_texture_backing::page_table) return virtual_texture_backing::page_table;
+
+        if (sparse_usable(_layerWidth, _layerHeight, _virtualLayers)) return virtual_texture_backing::sparse;
+
+        log::info << "Sparse textures unavailable for " << _layerWidth << "x" << _layerHeight << "x" << _virtualLayers
+                  << " array, using a page table";
+
+        return virtual_texture_backing::page_table;
+    }
+
+    unique_texture_array virtual_texture_array::make_backing_array(virtual_texture_backing _backing,
+                                                                   GLsizei _layerWidth,
+                                                                   GLsizei _layerHeight,
+                                                                   GLsizei _virtualLayers,
+                                                                   std::size_t _budgetBytes) noexcept(false) {
+        auto const layerBytes = full_chain_bytes(_layerWidth, _layerHeight);
+
+        if (_budgetBytes < layerBytes) {
+            throw virtual_texture_error{"Virtual texture budget of " + std::to_string(_budgetBytes) + " bytes cannot hold one layer of "
+                                        + std::to_string(layerBytes) + " bytes"};
+        }
+
+        if (_backing == virtual_texture_backing::sparse) return make_sparse_texture_array(_layerWidth, _layerHeight, _virtualLayers);
+
+        auto const physicalLayers = std::min(GLsizei(_budgetBytes / layerBytes), _virtualLayers);
+        return make_mipmapped_texture_array(_layerWidth, _layerHeight, physicalLayers);
+    }
+
+    virtual_texture_array::virtual_texture_array(GLsizei _layerWidth,
+                                                 GLsizei _layerHeight,
+                                                 GLsizei _virtualLayers,
+                                                 std::size_t _budgetBytes,
+                                                 loader _loader,
+                                                 std::optional<virtual_texture_backing> _backing) noexcept(false)
+    : m_backing(choose_backing(_layerWidth, _layerHeight, _virtualLayers, _backing)),
+      m_array(make_backing_array(m_backing, _layerWidth, _layerHeight, _virtualLayers, _budgetBytes)),
+      m_loader(std::move(_loader)),
+      m_budgetBytes(_budgetBytes),
+      m_layers(_virtualLayers),
+      m_pageTable(_virtualLayers, {not_resident, 0}) {
+        // So that marking a layer resident, after its pages are committed, cannot throw
+        m_residentLayers.reserve(_virtualLayers);
+
+        if (m_backing == virtual_texture_backing::sparse) {
+            glBindTexture(GL_TEXTURE_2D_ARRAY, m_array.raw_id(impl_call).value);
+            glGetTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_NUM_SPARSE_LEVELS_ARB, &m_sparseLevels);
+
+            GLboolean fullArrayMipmaps = GL_FALSE;
+            glGetBooleanv(GL_SPARSE_TEXTURE_FULL_ARRAY_CUBE_MIPMAPS_ARB, &fullArrayMipmaps);
+            m_sharedMipTail = fullArrayMipmaps == GL_FALSE;
+        } else {
+            // Reversed so that layers are handed out from 0
+            for (auto layer = m_array.layers(impl_call); layer > 0; --layer) m_freePhysicalLayers.push_back(layer - 1);
+        }
+
+        glBindBuffer(GL_TEXTURE_BUFFER, m_pageTableBuffer.value());
+        glBufferData(GL_TEXTURE_BUFFER, m_pageTable.size() * sizeof(m_pageTable[0]), m_pageTable.data(), GL_DYNAMIC_DRAW);
+
+        glBindTexture(GL_TEXTURE_BUFFER, m_pageTableTexture.value());
+        glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32I, m_pageTableBuffer.value());
+    }
+
+    void virtual_texture_array::note_sampled(texture_array_index _layer, GLint _finestLevel) noexcept {
+        if (_layer.value < 0 || _layer.value >= virtual_layers()) return;
+
+        auto& state = m_layers[_layer.value];
+
+        if (state.lastRequestedFrame != m_frame) {
+            state.lastRequestedFrame = m_frame;
+            state.requestedLevel = _finestLevel;
+            m_requestedThisFrame.push_back(_layer.value);
+        } else {
+            state.requestedLevel = std::min(state.requestedLevel, _finestLevel);
+        }
+    }
+
+    void virtual_texture_array::update() noexcept(false) {
+        auto const levels = m_array.levels(impl_call);
+        auto outOfBudget = false;
+
+        for (auto layer : m_requestedThisFrame) {
+            auto const& state = m_layers[layer];
+
+            // The page table backing always holds whole mip chains
+            auto const finestLevel = m_backing == virtual_texture_backing::sparse ? std::clamp(state.requestedLevel, 0, levels - 1) : 0;
+
+            auto const needed = additional_bytes(state, finestLevel);
+            if (needed == 0) continue;
+
+            if (!make_room(needed)) {
+                outOfBudget = true;
+                continue;
+            }
+
+            load(layer, finestLevel);
+        }
+
+        if (outOfBudget) log::warn << "Layers drawn in one frame exceed the virtual texture budget of " << m_budgetBytes << " bytes";
+
+        if (m_pageTableDirty) {
+            glBindBuffer(GL_TEXTURE_BUFFER, m_pageTableBuffer.value());
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, m_pageTable.size() * sizeof(m_pageTable[0]), m_pageTable.data());
+            m_pageTableDirty = false;
+        }
+
+        m_requestedThisFrame.clear();
+        ++m_frame;
+    }
+
+    bool virtual_texture_array::is_resident(texture_array_index _layer) const noexcept {
+        return _layer.value >= 0 && _layer.value < virtual_layers() && m_layers[_layer.value].physicalLayer != not_resident;
+    }
+
+    std::string virtual_texture_array::prepare_shader_source(std::string_view _source) const noexcept(false) {
+        auto result = insert_shader_declarations(_source, glsl_declarations);
+        if (!result) throw virtual_texture_error{"Shader source must start with a #version line"};
+
+        return std::move(*result);
+    }
+
+    std::size_t virtual_texture_array::level_bytes(GLint _level) const noexcept {
+        auto const width = std::max(m_array.width(impl_call) >> _level, 1);
+        auto const height = std::max(m_array.height(impl_call) >> _level, 1);
+
+        return std::size_t(width) * std::size_t(height) * texture::channels;
+    }
+
+    std::size_t virtual_texture_array::bytes_for_levels(GLint _finestLevel, GLint _coarsestLevel) const noexcept {
+        std::size_t result = 0;
+        for (auto level = _finestLevel; level < _coarsestLevel; ++level) result += level_bytes(level);
+        return result;
+    }
+
+    std::size_t virtual_texture_array::additional_bytes(layer_state const& _state, GLint _finestLevel) const noexcept {
+        auto const levels = m_array.levels(impl_call);
+
+        if (_state.physicalLayer == not_resident) return bytes_for_levels(_finestLevel, levels);
+        if (_state.finestLevel > _finestLevel) return bytes_for_levels(_finestLevel, _state.finestLevel);
+
+        return 0;
+    }
+
+    bool virtual_texture_array::make_room(std::size_t _bytes) noexcept {
+        while (m_committedBytes + _bytes > m_budgetBytes) {
+            auto victim = std::optional<GLint>();
+            auto victimFrame = std::numeric_limits<std::int64_t>::max();
+
+            for (auto layer : m_residentLayers) {
+                auto const lastRequested = m_layers[layer].lastRequestedFrame;
+
+                // Layers drawn this frame must stay
+                if (lastRequested < m_frame && lastRequested < victimFrame) {
+                    victim = layer;
+                    victimFrame = lastRequested;
+                }
+            }
+
+            if (!victim) return false;
+
+            evict(*victim);
+        }
+
+        return true;
+    }
+
+    void virtual_texture_array::load(GLint _layer, GLint _finestLevel) noexcept(false) {
+        auto const pixels = m_loader(texture_array_index{_layer});
+
+        if (pixels.width() != m_array.width(impl_call) || pixels.height() != m_array.height(impl_call)) {
+            throw virtual_texture_error{"Virtual texture layer " + std::to_string(_layer) + " loaded with the wrong size"};
+        }
+
+        auto& state = m_layers[_layer];
+        auto const levels = m_array.levels(impl_call);
+        auto const wasResident = state.physicalLayer != not_resident;
+
+        if (m_backing == virtual_texture_backing::page_table) {
+            // Only claimed once uploaded, since building the mip chain can throw
+            auto const physicalLayer = m_freePhysicalLayers.back();
+            (void)bind_texture_array_layer_mipmapped(m_array, texture_array_index{physicalLayer}, pixels);
+            m_freePhysicalLayers.pop_back();
+
+            state.physicalLayer = physicalLayer;
+            state.finestLevel = 0;
+            m_committedBytes += bytes_for_levels(0, levels);
+        } else {
+            // Only the levels that are not already committed need uploading
+            auto const endLevel = wasResident ? state.finestLevel : levels;
+
+            // Built before committing anything, since it can throw
+            auto const mipChain = endLevel > 1 ? make_texture_mip_chain(pixels) : std::vector<texture>();
+
+            set_commitment(_layer, _finestLevel, endLevel, true);
+
+            auto scope = gpu_scope("texture upload");
+
+            for (auto level = _finestLevel; level < endLevel; ++level) {
+                auto const& source = level == 0 ? pixels : mipChain[level - 1];
+
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY,
+                                level,
+                                0,
+                                0,
+                                _layer,
+                                source.width(),
+                                source.height(),
+                                1,
+                                GL_RGBA,
+                                GL_UNSIGNED_BYTE,
+                                source.data(impl_call));
+                render_stats_detail::count_texture_upload(std::size_t(source.width()) * std::size_t(source.height()) * texture::channels);
+            }
+
+            state.physicalLayer = _layer;
+            state.finestLevel = _finestLevel;
+            m_committedBytes += bytes_for_levels(_finestLevel, endLevel);
+        }
+
+        if (!wasResident) m_residentLayers.push_back(_layer);
+
+        m_pageTable[_layer] = {state.physicalLayer, state.finestLevel};
+        m_pageTableDirty = true;
+    }
+
+    void virtual_texture_array::evict(GLint _layer) noexcept {
+        auto& state = m_layers[_layer];
+        auto const levels = m_array.levels(impl_call);
+
+        if (m_backing == virtual_texture_backing::page_table) {
+            m_freePhysicalLayers.push_back(state.physicalLayer);
+        } else {
+            set_commitment(_layer, state.finestLevel, levels, false);
+        }
+
+        m_committedBytes -= bytes_for_levels(state.finestLevel, levels);
+        state.physicalLayer = not_resident;
+
+        auto const residentPosition = std::find(begin(m_residentLayers), end(m_residentLayers), _layer);
+        *residentPosition = m_residentLayers.back();
+        m_residentLayers.pop_back();
+
+        m_pageTable[_layer] = {not_resident, 0};
+        m_pageTableDirty = true;
+    }
+
+    void virtual_texture_array::set_commitment(GLint _layer, GLint _finestLevel, GLint _endLevel, bool _commit) noexcept {
+        auto const levels = m_array.levels(impl_call);
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, m_array.raw_id(impl_call).value);
+
+        for (auto level = _finestLevel; level < std::min(_endLevel, m_sparseLevels); ++level) {
+            glTexPageCommitmentARB(GL_TEXTURE_2D_ARRAY,
+                                   level,
+                                   0,
+                                   0,
+                                   _layer,
+                                   std::max(m_array.width(impl_call) >> level, 1),
+                                   std::max(m_array.height(impl_call) >> level, 1),
+                                   1,
+                                   _commit);
+        }
+
+        // The mip tail of a layer is committed as a whole, and only changes along with the
+        // coarsest level
+        if (_endLevel == levels && m_sparseLevels < levels) {
+            if (m_sharedMipTail) {
+                set_shared_mip_tail_commitment(_commit);
+            } else {
+                glTexPageCommitmentARB(GL_TEXTURE_2D_ARRAY,
+                                       m_sparseLevels,
+                                       0,
+                                       0,
+                                       _layer,
+                                       std::max(m_array.width(impl_call) >> m_sparseLevels, 1),
+                                       std::max(m_array.height(impl_call) >> m_sparseLevels, 1),
+                                       1,
+                                       _commit);
+            }
+        }
+    }
+
+    void virtual_texture_array::set_shared_mip_tail_commitment(bool _commit) noexcept {
+        // Decommitting the tail while another layer is resident would take that layer's
+        // coarsest levels with it
+        if (_commit) {
+            if (m_mipTailUsers++ != 0) return;
+        } else {
+            if (--m_mipTailUsers != 0) return;
+        }
+
+        glTexPageCommitmentARB(GL_TEXTURE_2D_ARRAY,
+                               m_sparseLevels,
+                               0,
+                               0,
+                               0,
+                               std::max(m_array.width(impl_call) >> m_sparseLevels, 1),
+                               std::max(m_array.height(impl_call) >> m_sparseLevels, 1),
+                               virtual_layers(),
+                               _commit);
+    }
+}    // namespace randomcat::engine::graphics::textures
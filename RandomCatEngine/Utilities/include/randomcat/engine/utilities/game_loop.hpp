@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+// fixed_timestep_loop runs the simulation in fixed steps and renders as often as it can.
+// Each frame, render receives alpha in [0, 1]: how far real time has moved from the
+// last simulated state towards the next one, for interpolating between the two.
+//
+// With threaded_simulation, steps run on their own thread at the simulation rate while
+// rendering stays on the calling thread (which must own the GL context). The two then
+// share state; interpolation_buffer is one way to hand it over.
+
+namespace randomcat::engine {
+    struct frame_pacing_stats {
+        std::int64_t simulationSteps;
+        std::int64_t renderedFrames;
+
+        // Steps skipped because the simulation fell too far behind real time
+        std::int64_t droppedSteps;
+
+        std::chrono::nanoseconds lastFrameTime;
+        std::chrono::nanoseconds averageFrameTime;    // Exponential moving average
+        std::chrono::nanoseconds lastStepDuration;    // Time spent in one call to simulate
+    };
+
+    class fixed_timestep_loop {
+    public:
+        using time = std::chrono::nanoseconds;
+        using clock_function = std::function<time()>;
+
+        struct options {
+            time step = std::chrono::nanoseconds(1'000'000'000 / 60);
+
+            // After this many steps in one frame, the rest of the backlog is dropped so
+            // that a slow simulation cannot fall further and further behind
+            int maxStepsPerFrame = 8;
+
+            bool threadedSimulation = false;
+        };
+
+        // The default clock is std::chrono::steady_clock
+        explicit fixed_timestep_loop(options _options, clock_function _clock = {}) noexcept(!"Allocates");
+
+        // Runs until stop is called, which may be from either callback
+        void run(std::function<void(time _step)> const& _simulate, std::function<void(float _alpha)> const& _render) noexcept(!"Rethrows");
+
+        void stop() noexcept { m_running = false; }
+
+        [[nodiscard]] auto const& loop_options() const noexcept { return m_options; }
+
+        // May be called from either callback
+        [[nodiscard]] frame_pacing_stats stats() const noexcept;
+
+    private:
+        void run_single_threaded(std::function<void(time)> const& _simulate, std::function<void(float)> const& _render) noexcept(false);
+        void run_threaded(std::function<void(time)> const& _simulate, std::function<void(float)> const& _render) noexcept(false);
+
+        void simulate_step(std::function<void(time)> const& _simulate) noexcept(false);
+        void record_frame(time _frameTime) noexcept;
+
+        options m_options;
+        clock_function m_clock;
+
+        std::atomic<bool> m_running{false};
+
+        // Atomic since either thread may read them
+        std::atomic<std::int64_t> m_simulationSteps{0};
+        std::atomic<std::int64_t> m_droppedSteps{0};
+        std::atomic<time::rep> m_lastStepDuration{0};
+        std::atomic<std::int64_t> m_renderedFrames{0};
+        std::atomic<time::rep> m_lastFrameTime{0};
+        std::atomic<time::rep> m_averageFrameTime{0};
+    };
+
+    // Holds the last two states published by a simulation thread, so that a rendering
+    // thread can interpolate between them. Copies happen under a lock, so State should be
+    // cheap to copy.
+    template<typename State>
+    class interpolation_buffer {
+    public:
+        explicit interpolation_buffer(State _initial) noexcept(!"Copies") : m_previous(_initial), m_current(std::move(_initial)) {}
+
+        void publish(State _state) noexcept(!"Moves") {
+            auto const lock = std::lock_guard(m_mutex);
+            m_previous = std::exchange(m_current, std::move(_state));
+        }
+
+        // Returns (previous, current)
+        [[nodiscard]] std::pair<State, State> read() const noexcept(!"Copies") {
+            auto const lock = std::lock_guard(m_mutex);
+            return {m_previous, m_current};
+        }
+
+    private:
+        mutable std::mutex m_mutex;
+        State m_previous;
+        State m_current;
+    };
+}    // namespace randomcat::engine
@@ -0,0 +1,146 @@
+#include "randomcat/engine/utilities/game_loop.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace randomcat::engine {
+    namespace {
+        // Weight of the newest frame in the moving average
+        auto constexpr frame_time_smoothing = 0.05;
+
+        [[nodiscard]] fixed_timestep_loop::time steady_now() noexcept {
+            return std::chrono::duration_cast<fixed_timestep_loop::time>(std::chrono::steady_clock::now().time_since_epoch());
+        }
+
+        [[nodiscard]] float step_fraction(fixed_timestep_loop::time _elapsed, fixed_timestep_loop::time _step) noexcept {
+            return std::clamp(float(_elapsed.count()) / float(_step.count()), 0.0f, 1.0f);
+        }
+    }    // namespace
+
+    fixed_timestep_loop::fixed_timestep_loop(options _options, clock_function _clock) noexcept(false)
+    : m_options(std::move(_options)), m_clock(_clock ? std::move(_clock) : clock_function(steady_now)) {}
+
+    void fixed_timestep_loop::run(std::function<void(time)> const& _simulate, std::function<void(float)> const& _render) noexcept(false) {
+        m_running = true;
+
+        if (m_options.threadedSimulation) {
+            run_threaded(_simulate, _render);
+        } else {
+            run_single_threaded(_simulate, _render);
+        }
+    }
+
+    frame_pacing_stats fixed_timestep_loop::stats() const noexcept {
+        return frame_pacing_stats{
+            m_simulationSteps, m_renderedFrames, m_droppedSteps, time{m_lastFrameTime}, time{m_averageFrameTime}, time{m_lastStepDuration}};
+    }
+
+    void fixed_timestep_loop::simulate_step(std::function<void(time)> const& _simulate) noexcept(false) {
+        auto const begin = m_clock();
+        _simulate(m_options.step);
+
+        m_lastStepDuration = (m_clock() - begin).count();
+        ++m_simulationSteps;
+    }
+
+    void fixed_timestep_loop::record_frame(time _frameTime) noexcept {
+        auto const frames = ++m_renderedFrames;
+        m_lastFrameTime = _frameTime.count();
+
+        // Only the rendering thread writes the average, so this need not be one atomic step
+        auto const average = m_averageFrameTime.load();
+        m_averageFrameTime =
+            frames == 1 ? _frameTime.count() : average + time::rep(frame_time_smoothing * double(_frameTime.count() - average));
+    }
+
+    void fixed_timestep_loop::run_single_threaded(std::function<void(time)> const& _simulate, std::function<void(float)> const& _render) noexcept(false) {
+        auto const step = m_options.step;
+        auto const maxBacklog = step * m_options.maxStepsPerFrame;
+
+        auto previous = m_clock();
+        auto accumulator = time(0);
+
+        while (m_running) {
+            auto const now = m_clock();
+            record_frame(now - previous);
+
+            accumulator += now - previous;
+            previous = now;
+
+            for (auto steps = 0; accumulator >= step && steps < m_options.maxStepsPerFrame && m_running; ++steps) {
+                simulate_step(_simulate);
+                accumulator -= step;
+            }
+
+            if (accumulator >= maxBacklog) {
+                m_droppedSteps += accumulator / step;
+                accumulator %= step;
+            }
+
+            if (!m_running) break;
+
+            _render(step_fraction(accumulator, step));
+        }
+    }
+
+    void fixed_timestep_loop::run_threaded(std::function<void(time)> const& _simulate, std::function<void(float)> const& _render) noexcept(false) {
+        auto const step = m_options.step;
+        auto const maxBacklog = step * m_options.maxStepsPerFrame;
+
+        // Real time at which the latest simulated state is due
+        auto lastStateTime = std::atomic<time::rep>(m_clock().count());
+
+        std::exception_ptr simulationError;
+
+        auto simulation = std::thread([&] {
+            try {
+                auto nextStepTime = time(lastStateTime) + step;
+
+                while (m_running) {
+                    auto const now = m_clock();
+
+                    if (now < nextStepTime) {
+                        // Woken periodically so that stop is noticed promptly
+                        std::this_thread::sleep_for(std::min(nextStepTime - now, step));
+                        continue;
+                    }
+
+                    if (now - nextStepTime >= maxBacklog) {
+                        m_droppedSteps += (now - nextStepTime) / step;
+                        nextStepTime = now;
+                    }
+
+                    simulate_step(_simulate);
+
+                    lastStateTime = nextStepTime.count();
+                    nextStepTime += step;
+                }
+            } catch (...) {
+                simulationError = std::current_exception();
+                m_running = false;
+            }
+        });
+
+        try {
+            auto previous = m_clock();
+
+            while (m_running) {
+                auto const now = m_clock();
+                record_frame(now - previous);
+                previous = now;
+
+                // Renders one step behind real time, between the last two published states
+                _render(step_fraction(now - time(lastStateTime), step));
+            }
+        } catch (...) {
+            m_running = false;
+            simulation.join();
+            throw;
+        }
+
+        simulation.join();
+
+        if (simulationError) std::rethrow_exception(simulationError);
+    }
+}    // namespace randomcat::engine
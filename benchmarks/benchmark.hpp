@@ -0,0 +1,68 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace randomcat::engine::benchmarks {
+    // Passed to each benchmark, which should run its measured code once per call to
+    // keep_running that returns true. Timing starts at the first call.
+    class benchmark_state {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        explicit benchmark_state(std::int64_t _iterations) noexcept : m_iterations(_iterations), m_remaining(_iterations) {}
+
+        [[nodiscard]] bool keep_running() noexcept {
+            if (m_remaining == m_iterations) m_start = clock::now();
+
+            if (m_remaining-- > 0) return true;
+
+            m_end = clock::now();
+            return false;
+        }
+
+        [[nodiscard]] auto iterations() const noexcept { return m_iterations; }
+
+        // Totals across all iterations, reported as rates
+        void set_items_processed(std::int64_t _items) noexcept { m_items = _items; }
+        void set_bytes_processed(std::int64_t _bytes) noexcept { m_bytes = _bytes; }
+
+        [[nodiscard]] auto items_processed() const noexcept { return m_items; }
+        [[nodiscard]] auto bytes_processed() const noexcept { return m_bytes; }
+
+        [[nodiscard]] auto elapsed() const noexcept { return m_end - m_start; }
+
+        // Whether keep_running was called until it returned false, so that elapsed is the
+        // time taken by every iteration
+        [[nodiscard]] bool finished() const noexcept { return m_remaining < 0; }
+
+    private:
+        std::int64_t m_iterations;
+        std::int64_t m_remaining;
+        std::int64_t m_items = 0;
+        std::int64_t m_bytes = 0;
+        clock::time_point m_start;
+        clock::time_point m_end;
+    };
+
+    using benchmark_function = std::function<void(benchmark_state&)>;
+
+    bool register_benchmark(std::string _name, benchmark_function _function) noexcept(!"Allocates");
+
+    // Keeps the compiler from discarding a computation whose result is otherwise unused
+    template<typename T>
+    inline void do_not_optimize(T const& _value) noexcept {
+        asm volatile("" : : "r,m"(_value) : "memory");
+    }
+
+    inline void clobber_memory() noexcept { asm volatile("" : : : "memory"); }
+}    // namespace randomcat::engine::benchmarks
+
+#define RC_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define RC_BENCHMARK_CONCAT(a, b) RC_BENCHMARK_CONCAT_IMPL(a, b)
+
+// Registers a function taking benchmark_state& under its own name
+#define RC_BENCHMARK(function)                                                                                                                     \
+    static bool const RC_BENCHMARK_CONCAT(rc_benchmark_registered_, __LINE__) = ::randomcat::engine::benchmarks::register_benchmark(#function, function)
@@ -0,0 +1,125 @@
+#include <string>
+#include <vector>
+
+#include "randomcat/engine/textures/graphics/image_kernels.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        namespace kernels = graphics::textures::image_kernels;
+
+        auto constexpr image_size = std::int32_t(1024);
+        auto constexpr image_pixels = std::size_t(image_size) * std::size_t(image_size);
+
+        [[nodiscard]] std::vector<kernels::pixel_value> make_image(std::size_t _bytes) noexcept(!"Allocates") {
+            std::vector<kernels::pixel_value> result(_bytes);
+            for (std::size_t i = 0; i < result.size(); ++i) result[i] = kernels::pixel_value(i * 31 + 7);
+            return result;
+        }
+
+        void fill_rgba(benchmark_state& _state, kernels::isa _isa) {
+            auto target = make_image(image_pixels * 4);
+
+            while (_state.keep_running()) {
+                kernels::fill_rgba(target.data(), image_pixels, {10, 20, 30, 255}, _isa);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 4);
+        }
+
+        void expand_rgb_to_rgba(benchmark_state& _state, kernels::isa _isa) {
+            auto const source = make_image(image_pixels * 3);
+            auto target = make_image(image_pixels * 4);
+
+            while (_state.keep_running()) {
+                kernels::expand_rgb_to_rgba(target.data(), source.data(), image_pixels, 255, _isa);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 7);
+        }
+
+        void premultiply_alpha(benchmark_state& _state, kernels::isa _isa) {
+            auto pixels = make_image(image_pixels * 4);
+
+            while (_state.keep_running()) {
+                kernels::premultiply_alpha(pixels.data(), image_pixels, _isa);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 8);
+        }
+
+        void swizzle_rgba(benchmark_state& _state, kernels::isa _isa) {
+            auto pixels = make_image(image_pixels * 4);
+
+            while (_state.keep_running()) {
+                kernels::swizzle_rgba(pixels.data(), pixels.data(), image_pixels, {2, 1, 0, 3}, _isa);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 8);
+        }
+
+        void downsample_rgba_2x(benchmark_state& _state, kernels::isa _isa) {
+            auto const source = make_image(image_pixels * 4);
+            auto target = make_image(image_pixels);
+
+            while (_state.keep_running()) {
+                kernels::downsample_rgba_2x(target.data(), source.data(), image_size, image_size, _isa);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 5);
+        }
+
+        void image_kernels_srgb_to_linear(benchmark_state& _state) {
+            auto pixels = make_image(image_pixels * 4);
+
+            while (_state.keep_running()) {
+                kernels::srgb_to_linear(pixels.data(), image_pixels);
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * image_pixels);
+            _state.set_bytes_processed(_state.iterations() * image_pixels * 8);
+        }
+
+        RC_BENCHMARK(image_kernels_srgb_to_linear);
+
+        // Registers each kernel once per instruction set supported here, so that the
+        // vectorized paths can be compared against the scalar one
+        bool const registered = [] {
+            using kernel_benchmark = void (*)(benchmark_state&, kernels::isa);
+
+            std::pair<char const*, kernel_benchmark> const benchmarks[] = {{"fill_rgba", fill_rgba},
+                                                                           {"expand_rgb_to_rgba", expand_rgb_to_rgba},
+                                                                           {"premultiply_alpha", premultiply_alpha},
+                                                                           {"swizzle_rgba", swizzle_rgba},
+                                                                           {"downsample_rgba_2x", downsample_rgba_2x}};
+
+            std::pair<char const*, kernels::isa> const isas[] = {{"scalar", kernels::isa::scalar},
+                                                                 {"ssse3", kernels::isa::ssse3},
+                                                                 {"avx2", kernels::isa::avx2}};
+
+            for (auto const& [isaName, isa] : isas) {
+                if (isa > kernels::best_isa()) continue;
+
+                for (auto const& [name, function] : benchmarks) {
+                    register_benchmark(std::string("image_kernels_") + name + "/" + isaName, [function = function, isa = isa](benchmark_state& _state) {
+                        function(_state, isa);
+                    });
+                }
+            }
+
+            return true;
+        }();
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
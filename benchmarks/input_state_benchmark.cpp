@@ -0,0 +1,69 @@
+#include <array>
+
+#include "randomcat/engine/input/input_state.hpp"
+#include "randomcat/engine/input/keycodes.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        using namespace input;
+
+        // Movement and action keys, the ones held most during play
+        std::array<keycode, 8> constexpr game_keys = {
+            keycode::kc_w, keycode::kc_a, keycode::kc_s, keycode::kc_d, keycode::kc_space, keycode::kc_lshift, keycode::kc_e, keycode::kc_q};
+
+        // A tick in which every game key is pressed or released, with the change set reused
+        // as controller does
+        void input_state_keyboard_update(benchmark_state& _state) {
+            keyboard_input_state_changes changes;
+            keyboard_input_state state;
+            auto down = true;
+
+            while (_state.keep_running()) {
+                changes.clear();
+                for (auto key : game_keys) changes.set_key_state(key, down ? key_state::down : key_state::up);
+
+                state.update(changes);
+                do_not_optimize(state);
+
+                down = !down;
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(game_keys.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(sizeof(keyboard_input_state)));
+        }
+
+        // Most ticks change no keys
+        void input_state_keyboard_update_unchanged(benchmark_state& _state) {
+            keyboard_input_state_changes changes;
+            keyboard_input_state state;
+
+            while (_state.keep_running()) {
+                changes.clear();
+                state.update(changes);
+                do_not_optimize(state);
+            }
+
+            _state.set_items_processed(_state.iterations());
+        }
+
+        void input_state_keyboard_query(benchmark_state& _state) {
+            keyboard_input_state state;
+            state.set_key_state(keycode::kc_w, key_state::down);
+            state.set_key_state(keycode::kc_lshift, key_state::down);
+
+            while (_state.keep_running()) {
+                auto downCount = 0;
+                for (auto key : game_keys) downCount += state.key_is_down(key) ? 1 : 0;
+                do_not_optimize(downCount);
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(game_keys.size()));
+        }
+
+        RC_BENCHMARK(input_state_keyboard_update);
+        RC_BENCHMARK(input_state_keyboard_update_unchanged);
+        RC_BENCHMARK(input_state_keyboard_query);
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
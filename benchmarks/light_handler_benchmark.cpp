@@ -0,0 +1,90 @@
+// light_handler::update needs a shader, so this runs only where a context can be made
+// without a display
+#if RC_ENGINE_HEADLESS
+
+#include <cstddef>
+
+#include "randomcat/engine/low_level/graphics/render_context.hpp"
+#include "randomcat/engine/low_level/graphics/shader.hpp"
+#include "randomcat/engine/render_objects/graphics/default_vertex.hpp"
+#include "randomcat/engine/utilities/graphics/lights.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        using namespace graphics;
+
+        // As many lights as BasicGame's shader allows
+        auto constexpr light_count = 128;
+
+        constexpr char const* const vertex_shader = R"(
+            #version 330 core
+            layout (location = 0) in vec3 aPos;
+            out vec3 fragPos;
+
+            void main() {
+                gl_Position = vec4(aPos, 1.0);
+                fragPos = aPos;
+            }
+        )";
+
+        // Uses every light member so that none of the uniforms are optimized out
+        constexpr char const* const fragment_shader = R"(
+            #version 330 core
+            in vec3 fragPos;
+            out vec4 FragColor;
+
+            struct Light {
+                vec3 position;
+                vec3 ambient;
+                vec3 diffuse;
+                vec3 specular;
+                float constant;
+                float linear;
+                float quadratic;
+            };
+
+            uniform Light lights[128];
+            uniform int lightsUsed;
+
+            void main() {
+                vec3 total = vec3(0);
+
+                for (int i = 0; i < lightsUsed; ++i) {
+                    float distance = length(lights[i].position - fragPos);
+                    float attenuation = 1.0 / (lights[i].constant + lights[i].linear * distance + lights[i].quadratic * distance * distance);
+                    total += (lights[i].ambient + lights[i].diffuse + lights[i].specular) * attenuation;
+                }
+
+                FragColor = vec4(total, 1.0);
+            }
+        )";
+
+        // Builds 7 uniform names per light and sets each one
+        void light_handler_update(benchmark_state& _state) {
+            auto const context = render_context(render_context::headless, 16, 16);
+            auto const lock = context.make_active_lock();
+
+            auto lightShader = shader<default_vertex, shader_capabilities<light_handler>>(
+                vertex_shader,
+                fragment_shader,
+                {{{0}, shader_input::vec3_type, shader_input_storage_type::floating_point, {offsetof(default_vertex, location)}, {sizeof(default_vertex)}}});
+
+            auto lights = lightShader.uniforms_as<light_handler>();
+
+            for (auto i = 0; i < light_count; ++i) {
+                lights.add_light({glm::vec3{float(i), 5, float(i)}, {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}, {1.0f, 0.09f, 0.032f}});
+            }
+
+            while (_state.keep_running()) lights.update();
+
+            _state.set_items_processed(_state.iterations() * light_count);
+            _state.set_bytes_processed(_state.iterations() * light_count * std::int64_t(sizeof(light_handler::light_t)));
+        }
+
+        RC_BENCHMARK(light_handler_update);
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
+
+#endif
@@ -0,0 +1,77 @@
+#include <ostream>
+#include <streambuf>
+
+#include "randomcat/engine/low_level/detail/log.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        // Discards output, counting it so that the formatter's throughput can be reported
+        class counting_buffer : public std::streambuf {
+        public:
+            [[nodiscard]] auto bytes_written() const noexcept { return m_bytesWritten; }
+
+        protected:
+            std::streamsize xsputn(char const*, std::streamsize _count) override {
+                m_bytesWritten += _count;
+                return _count;
+            }
+
+            int_type overflow(int_type _char) override {
+                if (!traits_type::eq_int_type(_char, traits_type::eof())) ++m_bytesWritten;
+                return traits_type::not_eof(_char);
+            }
+
+        private:
+            std::int64_t m_bytesWritten = 0;
+        };
+
+        // Flushes often enough that the queue never fills, so that the time includes the
+        // background thread's formatting and writing rather than dropped messages
+        auto constexpr messages_per_flush = 256;
+
+        template<typename WriteMessage>
+        void log_messages(benchmark_state& _state, WriteMessage _writeMessage) {
+            counting_buffer buffer;
+            std::ostream stream(&buffer);
+
+            log::set_log_output(stream);
+
+            auto sinceFlush = 0;
+
+            while (_state.keep_running()) {
+                _writeMessage();
+
+                if (++sinceFlush == messages_per_flush) {
+                    log::flush();
+                    sinceFlush = 0;
+                }
+            }
+
+            log::set_log_output(std::clog);
+
+            _state.set_items_processed(_state.iterations());
+            _state.set_bytes_processed(buffer.bytes_written());
+        }
+
+        void log_format_string(benchmark_state& _state) {
+            log_messages(_state, [] { log::info << "Context created with debugging"; });
+        }
+
+        // As BasicGame's per-second statistics
+        void log_format_chained(benchmark_state& _state) {
+            auto frames = 0;
+            log_messages(_state, [&] { log::info << "FPS: " << 59.94 << ", objects: " << ++frames; });
+        }
+
+        // Each newline is replaced with a continuation header
+        void log_format_multiline(benchmark_state& _state) {
+            log_messages(_state, [] { log::warn << "Shader compilation failed:\n0:12: error: undeclared identifier\n0:13: error: syntax error"; });
+        }
+
+        RC_BENCHMARK(log_format_string);
+        RC_BENCHMARK(log_format_chained);
+        RC_BENCHMARK(log_format_multiline);
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
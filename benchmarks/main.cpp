@@ -0,0 +1,95 @@
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        struct registered_benchmark {
+            std::string name;
+            benchmark_function function;
+        };
+
+        std::vector<registered_benchmark>& registry() noexcept {
+            static std::vector<registered_benchmark> benchmarks;
+            return benchmarks;
+        }
+
+        auto constexpr min_run_time = std::chrono::milliseconds(500);
+
+        // Iteration counts stop growing after this much wall-clock time, however little of it
+        // was timed (e.g. if setup outside the timed loop dominates)
+        auto constexpr max_scaling_time = std::chrono::seconds(30);
+
+        void print_rate(char const* _unit, std::int64_t _count, double _seconds) noexcept {
+            if (_count == 0) {
+                std::printf(" %16s", "");
+                return;
+            }
+
+            auto rate = double(_count) / _seconds;
+            char const* prefix = "";
+
+            for (auto nextPrefix : {"k", "M", "G"}) {
+                if (rate < 1000.0) break;
+                rate /= 1000.0;
+                prefix = nextPrefix;
+            }
+
+            std::printf(" %9.2f %s%s/s", rate, prefix, _unit);
+        }
+
+        // Returns false if the benchmark did not run its timed loop to the end
+        [[nodiscard]] bool run(registered_benchmark const& _benchmark) noexcept(!"Benchmarks may throw") {
+            auto const scalingStart = benchmark_state::clock::now();
+
+            // Grow the iteration count until a run is long enough to time reliably
+            for (std::int64_t iterations = 1;; iterations *= 2) {
+                auto state = benchmark_state(iterations);
+                _benchmark.function(state);
+
+                if (!state.finished()) {
+                    std::fprintf(stderr, "%s: did not call keep_running until it returned false\n", _benchmark.name.c_str());
+                    return false;
+                }
+
+                auto const scaling = iterations < (std::int64_t(1) << 40) && benchmark_state::clock::now() - scalingStart < max_scaling_time;
+                if (state.elapsed() < min_run_time && scaling) continue;
+
+                auto const seconds = std::chrono::duration<double>(state.elapsed()).count();
+
+                std::printf("%-48s %12.1f ns/iter", _benchmark.name.c_str(), seconds * 1e9 / double(iterations));
+                print_rate("items", state.items_processed(), seconds);
+                print_rate("B", state.bytes_processed(), seconds);
+                std::printf("\n");
+                return true;
+            }
+        }
+    }    // namespace
+
+    bool register_benchmark(std::string _name, benchmark_function _function) noexcept(false) {
+        registry().push_back(registered_benchmark{std::move(_name), std::move(_function)});
+        return true;
+    }
+}    // namespace randomcat::engine::benchmarks
+
+int main(int _argc, char** _argv) {
+    using namespace randomcat::engine::benchmarks;
+
+    auto const filter = std::string(_argc > 1 ? _argv[1] : "");
+
+    auto benchmarks = registry();
+    std::sort(begin(benchmarks), end(benchmarks), [](auto const& _first, auto const& _second) { return _first.name < _second.name; });
+
+    auto failed = false;
+
+    for (auto const& current : benchmarks) {
+        if (current.name.find(filter) == std::string::npos) continue;
+        if (!run(current)) failed = true;
+    }
+
+    return failed ? 1 : 0;
+}
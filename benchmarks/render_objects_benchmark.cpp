@@ -0,0 +1,329 @@
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "randomcat/engine/low_level/thread_pool.hpp"
+#include "randomcat/engine/render_objects/graphics/default_vertex.hpp"
+#include "randomcat/engine/render_objects/graphics/mesh_builder.hpp"
+#include "randomcat/engine/render_objects/graphics/object.hpp"
+#include "randomcat/engine/render_objects/graphics/rect_prism_batch.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        using namespace graphics;
+
+        // About the number of objects in the BasicGame world
+        auto constexpr object_count = std::size_t(1024);
+
+        // A large scene, where decomposing on one thread takes much of a frame
+        auto constexpr large_object_count = std::size_t(100000);
+
+        // As in BasicGame, a vertex with extra per-vertex data that objects are converted to
+        struct material_vertex {
+            default_vertex::location_t location;
+            default_vertex::texture_t texture;
+            glm::vec3 normal;
+            glm::vec3 color;
+            GLfloat shininess;
+        };
+
+        [[nodiscard]] material_vertex to_material_vertex(default_vertex const& _vertex) noexcept {
+            return material_vertex{_vertex.location, _vertex.texture, _vertex.normal, glm::vec3{0.5f, 0.5f, 0.5f}, 32.0f};
+        }
+
+        [[nodiscard]] textures::texture_rectangle whole_layer(std::int32_t _layer) noexcept {
+            return textures::texture_rectangle{texture_array_index{_layer}, textures::texture_rectangle::from_corner_and_dimensions, {0, 0}, 1.0f, 1.0f};
+        }
+
+        [[nodiscard]] glm::vec3 grid_position(std::size_t _index) noexcept {
+            return glm::vec3{float(_index % 32), float(_index / 32 % 32), float(_index / 1024)};
+        }
+
+        template<typename MakeObject>
+        [[nodiscard]] auto make_objects(MakeObject _makeObject, std::size_t _count = object_count) noexcept(!"Allocates") {
+            std::vector<decltype(_makeObject(std::size_t(0)))> objects;
+            objects.reserve(_count);
+
+            for (std::size_t i = 0; i < _count; ++i) objects.push_back(_makeObject(i));
+
+            return objects;
+        }
+
+        // Decomposes the objects into a vertex vector that is reused across iterations, as
+        // BasicGame does each frame
+        template<typename Vertex, typename Object>
+        void decompose(benchmark_state& _state, std::vector<Object> const& _objects) {
+            std::vector<Vertex> vertices;
+
+            while (_state.keep_running()) {
+                vertices.clear();
+                decompose_render_object_to<Vertex>(begin(_objects), end(_objects), std::back_inserter(vertices));
+                do_not_optimize(vertices.data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(vertices.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(vertices.size() * sizeof(Vertex)));
+        }
+
+        // As decompose, through a reused mesh_builder
+        template<typename Vertex, typename Object>
+        void build(benchmark_state& _state, std::vector<Object> const& _objects) {
+            mesh_builder<Vertex> builder;
+
+            while (_state.keep_running()) {
+                builder.clear();
+                builder.add(begin(_objects), end(_objects));
+                do_not_optimize(builder.data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(builder.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(builder.size() * sizeof(Vertex)));
+        }
+
+        // As build, with the objects split among a pool's threads
+        template<typename Vertex, typename Object>
+        void build_parallel(benchmark_state& _state, std::vector<Object> const& _objects) {
+            thread_pool pool;
+            mesh_builder<Vertex> builder;
+
+            while (_state.keep_running()) {
+                builder.clear();
+                builder.add(pool, begin(_objects), end(_objects));
+                do_not_optimize(builder.data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(builder.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(builder.size() * sizeof(Vertex)));
+        }
+
+        [[nodiscard]] auto make_large_cubes() noexcept(!"Allocates") {
+            return make_objects([](std::size_t _index) { return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0)); }, large_object_count);
+        }
+
+        [[nodiscard]] auto make_large_regular_polygons() noexcept(!"Allocates") {
+            return make_objects([](std::size_t _index) { return render_object_regular_polygon<>(8, grid_position(_index), 0.5f, whole_layer(0)); },
+                                large_object_count);
+        }
+
+        void render_objects_decompose_triangle(benchmark_state& _state) {
+            decompose<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                          auto const position = grid_position(_index);
+                                          return render_object_triangle<>(
+                                              location_triangle{{position}, {position + glm::vec3{1, 0, 0}}, {position + glm::vec3{0, 1, 0}}},
+                                              textures::texture_triangle{texture_array_index{0}, {0, 0}, {1, 0}, {0, 1}});
+                                      }));
+        }
+
+        void render_objects_decompose_rectangle(benchmark_state& _state) {
+            decompose<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                          auto const position = grid_position(_index);
+                                          return render_object_rectangle<>(location_quad{{position},
+                                                                                         {position + glm::vec3{1, 0, 0}},
+                                                                                         {position + glm::vec3{1, 1, 0}},
+                                                                                         {position + glm::vec3{0, 1, 0}}},
+                                                                           whole_layer(0));
+                                      }));
+        }
+
+        void render_objects_decompose_rect_prism(benchmark_state& _state) {
+            decompose<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                          return render_object_rect_prism<>(grid_position(_index), glm::vec3{1, 2, 3}, whole_layer(0));
+                                      }));
+        }
+
+        void render_objects_decompose_cube(benchmark_state& _state) {
+            decompose<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                          return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0));
+                                      }));
+        }
+
+        void render_objects_decompose_regular_polygon(benchmark_state& _state) {
+            decompose<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                          return render_object_regular_polygon<>(8, grid_position(_index), 0.5f, whole_layer(0));
+                                      }));
+        }
+
+        void render_objects_decompose_converted_cube(benchmark_state& _state) {
+            decompose<material_vertex>(_state, make_objects([](std::size_t _index) {
+                                           return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0))
+                                               .use_vertex<material_vertex>(to_material_vertex);
+                                       }));
+        }
+
+        void render_objects_build_rect_prism(benchmark_state& _state) {
+            build<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                      return render_object_rect_prism<>(grid_position(_index), glm::vec3{1, 2, 3}, whole_layer(0));
+                                  }));
+        }
+
+        void render_objects_build_cube(benchmark_state& _state) {
+            build<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                      return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0));
+                                  }));
+        }
+
+        void render_objects_build_regular_polygon(benchmark_state& _state) {
+            build<default_vertex>(_state, make_objects([](std::size_t _index) {
+                                      return render_object_regular_polygon<>(8, grid_position(_index), 0.5f, whole_layer(0));
+                                  }));
+        }
+
+        void render_objects_build_converted_cube(benchmark_state& _state) {
+            build<material_vertex>(_state, make_objects([](std::size_t _index) {
+                                       return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0))
+                                           .use_vertex<material_vertex>(to_material_vertex);
+                                   }));
+        }
+
+        void render_objects_build_streams_cube(benchmark_state& _state) {
+            auto const cubes = make_objects([](std::size_t _index) { return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0)); });
+            mesh_streams streams;
+
+            while (_state.keep_running()) {
+                streams.clear();
+                streams.add(begin(cubes), end(cubes));
+                do_not_optimize(streams.locations().data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(streams.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(streams.size() * sizeof(default_vertex)));
+        }
+
+        void render_objects_construct_cube(benchmark_state& _state) {
+            auto const texture = whole_layer(0);
+            auto index = std::size_t(0);
+
+            while (_state.keep_running()) {
+                auto const cube = render_object_cube<>(grid_position(index++ % object_count), 1.0f, texture);
+                do_not_optimize(cube);
+            }
+
+            _state.set_items_processed(_state.iterations());
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(sizeof(render_object_cube<>)));
+        }
+
+        void render_objects_use_vertex_cube(benchmark_state& _state) {
+            auto const cubes = make_objects([](std::size_t _index) { return render_object_cube<>(grid_position(_index), 1.0f, whole_layer(0)); });
+            auto index = std::size_t(0);
+
+            while (_state.keep_running()) {
+                auto const converted = cubes[index++ % object_count].use_vertex<material_vertex>(to_material_vertex);
+                do_not_optimize(converted);
+            }
+
+            // 6 faces of 2 triangles
+            _state.set_items_processed(_state.iterations() * 36);
+            _state.set_bytes_processed(_state.iterations() * 36 * std::int64_t(sizeof(material_vertex)));
+        }
+
+        void render_objects_use_vertex_regular_polygon(benchmark_state& _state) {
+            auto const polygon = render_object_regular_polygon<>(64, glm::vec3{0, 0, 0}, 1.0f, whole_layer(0));
+
+            while (_state.keep_running()) {
+                auto const converted = polygon.use_vertex<material_vertex>(to_material_vertex);
+                do_not_optimize(converted.triangles().data());
+            }
+
+            _state.set_items_processed(_state.iterations() * 64 * 3);
+            _state.set_bytes_processed(_state.iterations() * 64 * 3 * std::int64_t(sizeof(material_vertex)));
+        }
+
+        void render_objects_build_large_cube(benchmark_state& _state) { build<default_vertex>(_state, make_large_cubes()); }
+
+        void render_objects_build_large_cube_parallel(benchmark_state& _state) { build_parallel<default_vertex>(_state, make_large_cubes()); }
+
+        void render_objects_build_large_regular_polygon(benchmark_state& _state) { build<default_vertex>(_state, make_large_regular_polygons()); }
+
+        void render_objects_build_large_regular_polygon_parallel(benchmark_state& _state) {
+            build_parallel<default_vertex>(_state, make_large_regular_polygons());
+        }
+
+        // The per-object way of making a frame of cubes: constructing each one, then adding
+        // its vertices to a reused mesh_builder
+        void render_objects_construct_and_build_cubes(benchmark_state& _state) {
+            auto const texture = textures::texture_quad(whole_layer(0));
+            mesh_builder<default_vertex> builder;
+
+            while (_state.keep_running()) {
+                builder.clear();
+
+                for (std::size_t i = 0; i < object_count; ++i) builder.add(render_object_cube<>(grid_position(i), 1.0f, texture));
+
+                do_not_optimize(builder.data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(builder.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(builder.size() * sizeof(default_vertex)));
+        }
+
+        // The same cubes as render_objects_construct_and_build_cubes, from arrays of their
+        // parameters
+        void batch_cubes(benchmark_state& _state, rect_prism_batch::isa _isa) {
+            std::vector<glm::vec3> centers;
+            for (std::size_t i = 0; i < object_count; ++i) centers.push_back(grid_position(i));
+
+            auto const sides = std::vector<float>(object_count, 1.0f);
+            auto const quads = std::vector<textures::texture_quad>(object_count, whole_layer(0));
+            auto vertices = std::vector<default_vertex>(object_count * rect_prism_batch::vertices_per_prism);
+
+            while (_state.keep_running()) {
+                rect_prism_batch::write_cubes(vertices.data(),
+                                              object_count,
+                                              centers.data(),
+                                              sides.data(),
+                                              quads.data(),
+                                              rect_prism_batch::texture_layout::per_prism,
+                                              _isa);
+
+                do_not_optimize(vertices.data());
+                clobber_memory();
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(vertices.size()));
+            _state.set_bytes_processed(_state.iterations() * std::int64_t(vertices.size() * sizeof(default_vertex)));
+        }
+
+        RC_BENCHMARK(render_objects_decompose_triangle);
+        RC_BENCHMARK(render_objects_decompose_rectangle);
+        RC_BENCHMARK(render_objects_decompose_rect_prism);
+        RC_BENCHMARK(render_objects_decompose_cube);
+        RC_BENCHMARK(render_objects_decompose_regular_polygon);
+        RC_BENCHMARK(render_objects_decompose_converted_cube);
+        RC_BENCHMARK(render_objects_build_rect_prism);
+        RC_BENCHMARK(render_objects_build_cube);
+        RC_BENCHMARK(render_objects_build_regular_polygon);
+        RC_BENCHMARK(render_objects_build_converted_cube);
+        RC_BENCHMARK(render_objects_build_streams_cube);
+        RC_BENCHMARK(render_objects_build_large_cube);
+        RC_BENCHMARK(render_objects_build_large_cube_parallel);
+        RC_BENCHMARK(render_objects_build_large_regular_polygon);
+        RC_BENCHMARK(render_objects_build_large_regular_polygon_parallel);
+        RC_BENCHMARK(render_objects_construct_cube);
+        RC_BENCHMARK(render_objects_use_vertex_cube);
+        RC_BENCHMARK(render_objects_use_vertex_regular_polygon);
+        RC_BENCHMARK(render_objects_construct_and_build_cubes);
+
+        // Registers the batch once per instruction set supported here
+        bool const registered = [] {
+            std::pair<char const*, rect_prism_batch::isa> const isas[] = {{"scalar", rect_prism_batch::isa::scalar},
+                                                                          {"sse2", rect_prism_batch::isa::sse2},
+                                                                          {"avx2", rect_prism_batch::isa::avx2}};
+
+            for (auto const& [isaName, isa] : isas) {
+                if (isa > rect_prism_batch::best_isa()) continue;
+
+                register_benchmark(std::string("render_objects_batch_cubes/") + isaName, [isa = isa](benchmark_state& _state) { batch_cubes(_state, isa); });
+            }
+
+            return true;
+        }();
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
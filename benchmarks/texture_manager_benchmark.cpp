@@ -0,0 +1,86 @@
+#include <string>
+#include <vector>
+
+#include "randomcat/engine/textures/graphics/color_texture.hpp"
+#include "randomcat/engine/textures/graphics/texture_manager.hpp"
+
+#include "benchmark.hpp"
+
+namespace randomcat::engine::benchmarks {
+    namespace {
+        using namespace graphics::textures;
+
+        auto constexpr texture_count = std::size_t(256);
+
+        // Shaped like the paths that load_texture_file registers
+        [[nodiscard]] std::vector<std::string> make_texture_names() noexcept(!"Allocates") {
+            std::vector<std::string> names;
+            names.reserve(texture_count);
+
+            for (std::size_t i = 0; i < texture_count; ++i) names.push_back("texture/blocks/block_" + std::to_string(i) + ".png");
+
+            return names;
+        }
+
+        [[nodiscard]] std::int64_t total_length(std::vector<std::string> const& _names) noexcept {
+            std::int64_t result = 0;
+            for (auto const& name : _names) result += std::int64_t(name.size());
+            return result;
+        }
+
+        void texture_manager_get_texture(benchmark_state& _state) {
+            auto const names = make_texture_names();
+            auto const pixels = color_texture(4, 4, graphics::color_rgba{1, 1, 1, 1});
+
+            texture_manager manager;
+            for (auto const& name : names) manager.add_texture(name, pixels);
+
+            auto index = std::size_t(0);
+
+            while (_state.keep_running()) {
+                auto const& found = manager.get_texture(names[index++ % texture_count]);
+                do_not_optimize(&found);
+            }
+
+            _state.set_items_processed(_state.iterations());
+            _state.set_bytes_processed(_state.iterations() * total_length(names) / std::int64_t(texture_count));
+        }
+
+        void texture_manager_has_texture_missing(benchmark_state& _state) {
+            auto const names = make_texture_names();
+            auto const pixels = color_texture(4, 4, graphics::color_rgba{1, 1, 1, 1});
+
+            texture_manager manager;
+            for (std::size_t i = 0; i < texture_count; i += 2) manager.add_texture(names[i], pixels);
+
+            auto index = std::size_t(1);
+
+            while (_state.keep_running()) {
+                do_not_optimize(manager.has_texture(names[index]));
+                index = (index + 2) % texture_count;
+            }
+
+            _state.set_items_processed(_state.iterations());
+            _state.set_bytes_processed(_state.iterations() * total_length(names) / std::int64_t(texture_count));
+        }
+
+        // Fills a fresh manager each iteration, as loading a texture pack does
+        void texture_manager_add_texture(benchmark_state& _state) {
+            auto const names = make_texture_names();
+            auto const pixels = color_texture(4, 4, graphics::color_rgba{1, 1, 1, 1});
+
+            while (_state.keep_running()) {
+                texture_manager manager;
+                for (auto const& name : names) manager.add_texture(name, pixels);
+                do_not_optimize(&manager);
+            }
+
+            _state.set_items_processed(_state.iterations() * std::int64_t(texture_count));
+            _state.set_bytes_processed(_state.iterations() * total_length(names));
+        }
+
+        RC_BENCHMARK(texture_manager_get_texture);
+        RC_BENCHMARK(texture_manager_has_texture_missing);
+        RC_BENCHMARK(texture_manager_add_texture);
+    }    // namespace
+}    // namespace randomcat::engine::benchmarks
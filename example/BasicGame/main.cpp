@@ -1,7 +1,9 @@
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <thread>
 #include <type_traits>
 //#include <vector>
@@ -12,14 +14,20 @@
 #include <randomcat/engine/input/controller.hpp>
 #include <randomcat/engine/input/input_state.hpp>
 #include <randomcat/engine/input/keycodes.hpp>
+#include <randomcat/engine/low_level/binary_log.hpp>
 #include <randomcat/engine/low_level/graphics/gl_wrappers/texture_raii.hpp>
+#include <randomcat/engine/low_level/graphics/gpu_profiler.hpp>
 #include <randomcat/engine/low_level/graphics/render_context.hpp>
+#include <randomcat/engine/low_level/graphics/render_stats.hpp>
 #include <randomcat/engine/low_level/graphics/shader.hpp>
 #include <randomcat/engine/low_level/init.hpp>
+#include <randomcat/engine/low_level/profiling.hpp>
 #include <randomcat/engine/low_level/window.hpp>
 #include <randomcat/engine/render_objects/graphics/default_vertex.hpp>
+#include <randomcat/engine/render_objects/graphics/mesh_builder.hpp>
 #include <randomcat/engine/render_objects/graphics/object.hpp>
 #include <randomcat/engine/textures/graphics/color_texture.hpp>
+#include <randomcat/engine/textures/graphics/hot_reload.hpp>
 #include <randomcat/engine/textures/graphics/texture_binder.hpp>
 #include <randomcat/engine/textures/graphics/texture_fs.hpp>
 #include <randomcat/engine/textures/graphics/texture_manager.hpp>
@@ -39,7 +47,7 @@ static_assert(std::numeric_limits<double>::is_iec559);
 static_assert(std::numeric_limits<long double>::is_iec559);
 
 namespace {
-    glm::vec3 process_movement(input::keyboard_input_state const& _inputState, glm::vec3 const& _camDir, std::chrono::milliseconds _delta) {
+    glm::vec3 process_movement(input::keyboard_input_state const& _inputState, glm::vec3 const& _camDir, system_timer::time _delta) {
         constexpr auto zero_y = [](glm::vec3 vec) { return glm::vec3(vec.x, 0, vec.z); };
         constexpr auto movementSpeed = 0.01f;
 
@@ -61,7 +69,7 @@ namespace {
         if (_inputState.key_is_down(input::keycode::kc_lshift)) verticalMovement += glm::vec3{0, -1, 0};
 
         return ((movement != glm::vec3{0.0f} ? glm::normalize(movement) : glm::vec3{0.0f}) + verticalMovement) * movementSpeed
-               * static_cast<float>(_delta.count());
+               * std::chrono::duration<float, std::milli>(_delta).count();
     }
 
     std::chrono::seconds constexpr BENCHMARK_TIME = std::chrono::seconds(1000);
@@ -70,7 +78,10 @@ namespace {
 
 namespace units = ::randomcat::units;
 
-int main() {
+// Usage: BasicGame [--record <file> | --replay <file>] [--stats-log <file>]
+// A replay ends when its recording does, so that benchmark runs see identical input.
+// --stats-log writes each frame's render statistics as a binary log, for LogDecoder.
+int main(int argc, char** argv) {
     using vertex = basic_game::lighting_vertex;
     using renderer = vertex_renderer<vertex>;
     using render_cube = render_object_cube<>;
@@ -85,8 +96,28 @@ int main() {
         auto renderContext = render_context(window, render_context::flags::debug);
         auto renderContextLock = renderContext.make_active_lock();
         auto engine = controller();
+
+        std::optional<log::binary_log_writer> statsLog;
+
+        for (auto arg = 1; arg < argc; arg += 2) {
+            auto const option = std::string_view(argv[arg]);
+
+            if (arg + 1 < argc && option == "--record") {
+                engine.start_recording(argv[arg + 1]);
+            } else if (arg + 1 < argc && option == "--replay") {
+                engine.start_replay(argv[arg + 1]);
+            } else if (arg + 1 < argc && option == "--stats-log") {
+                statsLog.emplace(argv[arg + 1]);
+            } else {
+                log::error << "Usage: " << argv[0] << " [--record <file> | --replay <file>] [--stats-log <file>]";
+                return 1;
+            }
+        }
         auto theShader = basic_game::custom_shader();
 
+        auto profiler = gpu_profiler();
+        auto profilerLock = profiler.make_active_lock();
+
         window.set_cursor_shown(false);
 
         textures::texture_manager textureManager;
@@ -107,6 +138,13 @@ int main() {
             return textures::texture_rectangle{_rect.layer(), textures::texture_rectangle::from_corner_and_dimensions, _rect.top_left(), xDim * 0.5f, yDim};
         };
 
+        // Does nothing unless built with RC_ENGINE_HOT_RELOAD
+        auto hotReloader = textures::hot_reloader();
+        hotReloader.watch_texture(textureManager, "texture/wall.jpg", textureArray_, wallTexture_.layer());
+        hotReloader.watch_texture(textureManager, "texture/text.jpg", textureArray_, textTexture_.layer());
+        hotReloader.watch_texture(textureManager, "texture/cross.png", textureArray_, crossTexture_.layer());
+        hotReloader.watch_texture(textureManager, "texture/translucency.png", textureArray_, translucencyTexture_.layer());
+
         [[maybe_unused]] auto const& textureArray = textureArray_;
         [[maybe_unused]] auto const& wallTexture = halfTexture(wallTexture_);
         [[maybe_unused]] auto const& textTexture = halfTexture(textTexture_);
@@ -119,6 +157,7 @@ int main() {
         glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ZERO);
 
         auto camPos = glm::vec3{4.5f, 15.0f, 4.5f};
+        auto movementKeys = input::keyboard_input_state();
 
         auto distanceToCam = [&](auto const& cube) { return glm::distance(camPos, cube.center()); };
 
@@ -126,7 +165,7 @@ int main() {
         auto pitch = units::degrees(-90);
         float constexpr sensitivity = 0.1f;
 
-        std::chrono::milliseconds currentTime = engine.timer().current_time();
+        auto currentTime = engine.timer().current_time();
         auto lastPlace = currentTime;
 
         static_assert(std::is_same_v<decltype(decompose_render_object_to<void>(12, nullptr)), std::nullptr_t>);
@@ -145,8 +184,7 @@ int main() {
 
         constexpr auto roundVec3 = [](glm::vec3 vec) { return glm::vec3{round(vec.x), round(vec.y), round(vec.z)}; };
 
-        std::vector<vertex> vertices;
-        vertices.reserve(100 * 36);
+        auto mesh = mesh_builder<vertex>();
 
         [[maybe_unused]] auto const textCube = [&](glm::vec3 pos) { return render_cube{pos, 1, textTexture}; };
         [[maybe_unused]] auto const wallCube = [&](glm::vec3 pos) { return render_cube{pos, 1, wallTexture}; };
@@ -214,6 +252,7 @@ int main() {
         lightHandler.update();
 
         while (true) {
+            hotReloader.apply_pending();
             engine.tick();
             auto const& inputState = engine.inputs();
             auto const& inputChanges = engine.input_changes();
@@ -229,7 +268,21 @@ int main() {
             if (currentTime > lastSecondTime + 1s) {
                 lastSecondTime = currentTime;
                 log::info << "FPS: " << engine.timer().fps();
+                RC_LOG(INFO) << "Frame times: " << engine.timer().frame_stats().summary();
                 log::info << "Objects: " << objects.size();
+                log::info << "Last frame: " << last_frame_render_stats();
+
+                {
+                    // No text rendering yet, so the title bar is the overlay
+                    auto const& stats = last_frame_render_stats();
+                    auto title = std::ostringstream();
+                    title << "Twurtle Engine | " << engine.timer().fps() << " FPS | " << stats.drawCalls << " draws | "
+                          << stats.verticesUploaded << " vertices | " << stats.stateBinds << " binds";
+                    window.set_title(title.str());
+                }
+
+                for (auto const& timing : profiler.timings()) log::info << "GPU scope " << timing;
+                profiler.reset();
             }
 
             auto camDir = as_glm({.yaw = yaw, .pitch = pitch});
@@ -261,17 +314,28 @@ int main() {
             }
 
             renderContext.render([&] {
-                vertices.clear();
+                mesh.clear();
                 std::sort(begin(objects), end(objects), [&](auto const& first, auto const& second) {
                     return distanceToCam(second) < distanceToCam(first);
                 });
-                decompose_render_object_to<vertex>(begin(objects), end(objects), std::back_inserter(vertices));
-                decompose_render_object_to<vertex>(render_object_regular_polygon<default_vertex>(currentTime.count() / 1000, {0, 5, 0}, 4, wallTexture)
-                                                       .use_vertex<vertex>(toGameVertex),
-                                                   std::back_inserter(vertices));
-                vertexVecRenderer(vertices);
+                mesh.add(begin(objects), end(objects));
+                mesh.add(render_object_regular_polygon<default_vertex>(std::chrono::duration_cast<std::chrono::seconds>(currentTime).count(), {0, 5, 0}, 4, wallTexture)
+                             .use_vertex<vertex>(toGameVertex));
+                vertexVecRenderer(mesh);
             });
 
+            if (statsLog) {
+                auto const& stats = last_frame_render_stats();
+                statsLog->write("frame",
+                                log::field("frame_us", std::chrono::duration_cast<std::chrono::microseconds>(engine.timer().delta_time()).count()),
+                                log::field("draws", stats.drawCalls),
+                                log::field("vertices", stats.verticesUploaded),
+                                log::field("vertex_bytes", stats.vertexBytesUploaded),
+                                log::field("binds", stats.stateBinds),
+                                log::field("uniform_sets", stats.uniformSets),
+                                log::field("texture_uploads", stats.textureUploads));
+            }
+
             yaw += units::degrees(inputChanges.mouse().delta_x() * sensitivity);
             pitch += units::degrees(-inputChanges.mouse().delta_y() * sensitivity);
 
@@ -281,7 +345,31 @@ int main() {
 
             if (inputState.keyboard().key_is_down(input::keycode::kc_r)) objects.clear();
 
-            camPos += process_movement(inputState.keyboard(), camDir, engine.timer().delta_time());
+            if (inputChanges.keyboard().key_went_to(input::keycode::kc_p, input::key_state::down)) {
+                profiling::write_chrome_trace("trace.json");
+                log::info << (profiling::enabled ? "Wrote CPU profile to trace.json" : "Wrote empty CPU profile to trace.json; build with RC_ENGINE_PROFILING");
+            }
+
+            {
+                // Move with the keys that were held during each part of the tick, rather than
+                // with the keys held at its end for the whole of it
+                auto segmentStart = engine.timer().previous_time();
+
+                for (auto const& event : engine.events()) {
+                    if (event.type == input_event_type::mouse_motion) continue;
+
+                    camPos += process_movement(movementKeys, camDir, event.timestamp - segmentStart);
+                    segmentStart = event.timestamp;
+
+                    movementKeys.set_key_state(event.key, event.type == input_event_type::key_down ? key_state::down : key_state::up);
+                }
+
+                camPos += process_movement(movementKeys, camDir, engine.timer().current_time() - segmentStart);
+
+                // The event queue drops events when it overflows, and a dropped key up would
+                // otherwise leave the key held for good
+                movementKeys = inputState.keyboard();
+            }
 
             cam.update(genCameraState(position(camPos), direction({.yaw = yaw, .pitch = pitch})));
 
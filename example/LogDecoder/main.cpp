@@ -0,0 +1,32 @@
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+
+#include <randomcat/engine/low_level/binary_log.hpp>
+
+using namespace randomcat;
+using namespace randomcat::engine;
+
+// Usage: LogDecoder <binary log>
+// Prints one line per record: milliseconds since the log was started, the event name
+// and its fields.
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " <binary log>\n";
+        return 2;
+    }
+
+    try {
+        auto reader = log::binary_log_reader(argv[1]);
+
+        auto const startTime = std::chrono::system_clock::to_time_t(reader.start_time());
+        std::tm formatTime;
+        localtime_r(&startTime, &formatTime);
+        std::cout << "# Started " << std::put_time(&formatTime, "%Y-%m-%d %H:%M:%S") << "\n";
+
+        while (auto const record = reader.read_record()) std::cout << *record << "\n";
+    } catch (std::exception& e) {
+        std::cerr << "Error decoding binary log: " << e.what() << "\n";
+        return 1;
+    }
+}
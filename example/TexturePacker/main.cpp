@@ -0,0 +1,39 @@
+#include <iostream>
+#include <vector>
+
+#include <randomcat/engine/low_level/detail/log.hpp>
+#include <randomcat/engine/textures/graphics/texture_fs.hpp>
+#include <randomcat/engine/textures/graphics/texture_pack.hpp>
+
+using namespace randomcat;
+using namespace randomcat::engine;
+using namespace randomcat::engine::graphics;
+
+// Usage: TexturePacker <output pack> <image>...
+// Each image is stored under the same name load_texture_file would register it with.
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <output pack> <image>...\n";
+        return 2;
+    }
+
+    try {
+        std::vector<fs::path> paths(argv + 2, argv + argc);
+
+        auto pending = textures::load_texture_files_async(paths);
+
+        std::vector<textures::texture> images;
+        images.reserve(pending.size());
+        for (auto& image : pending) images.push_back(image.get());
+
+        textures::texture_pack_writer writer;
+        for (std::size_t i = 0; i < paths.size(); ++i) writer.add_texture(paths[i].relative_path().string(), images[i]);
+
+        writer.write(argv[1]);
+
+        log::info << "Packed " << images.size() << " textures into " << argv[1];
+    } catch (std::exception& e) {
+        log::error << "Error creating texture pack: " << e.what();
+        return 1;
+    }
+}